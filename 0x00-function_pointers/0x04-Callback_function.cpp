@@ -1,14 +1,23 @@
 #include <iostream>
-#include <functional>
-#include <vector>
+#include "signal.hpp"
+#include "../0x07-concurrency/scopedTimer.hpp"
 
+// The callbacks are kept in a Signal (signal.hpp) instead of a std::vector<std::function<void()>>: a capturing
+// lambda is stored in the slot without a heap allocation, and registerCallback returns a handle that removes
+// the callback again, even from inside a callback while the button is being pressed.
 class Button {
 public:
-    using CallbackFunction = std::function<void()>;
+    using CallbackFunction = Signal<>::Slot;
+    using Connection = Signal<>::Connection;
 
     // Register a callback function for the "pressed" event
-    void registerCallback(CallbackFunction callback) {
-        callbacks.push_back(callback);
+    Connection registerCallback(CallbackFunction callback) {
+        return callbacks.connect(std::move(callback));
+    }
+
+    // Remove a callback; false if it was already removed
+    bool unregisterCallback(Connection connection) {
+        return callbacks.disconnect(connection);
     }
 
     // Simulate the button being pressed
@@ -16,13 +25,12 @@ public:
         std::cout << "Button Pressed!" << std::endl;
 
         // Notify all registered callback functions
-        for (const auto& callback : callbacks) {
-            callback();
-        }
+        SCOPED_TIMER("Button::press callbacks");
+        callbacks.emit();
     }
 
 private:
-    std::vector<CallbackFunction> callbacks;
+    Signal<> callbacks;
 };
 
 // Example callback functions
@@ -42,8 +50,18 @@ int main() {
     myButton.registerCallback(onButtonClick);
     myButton.registerCallback(onButtonPress);
 
+    // A one-shot callback: it removes itself the first time it runs (during press())
+    Button::Connection once;
+    once = myButton.registerCallback([&myButton, &once] {
+        std::cout << "One-shot callback, unregistering itself" << std::endl;
+        myButton.unregisterCallback(once);
+    });
+
     // Simulate the button being pressed
     myButton.press();
+    // the one-shot callback is gone
+    myButton.press();
 
+    INSTRUMENT_REPORT(std::cout);
     return 0;
 }
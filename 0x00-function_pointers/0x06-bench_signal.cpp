@@ -0,0 +1,151 @@
+// Benchmarks for the callback list of Button (0x04-Callback_function.cpp): the std::vector<std::function<void()>>
+// it used to have against Signal<> (signal.hpp), with 1, 10 and 100 callbacks (the payload). Every callback is a
+// lambda that captures 24 bytes (a pointer and two values), more than the 16 bytes std::function keeps inline:
+// * emit/vector_std_function, emit/Signal: one press(), calling every callback; ns/op is per press;
+// * register/vector_std_function, register/Signal: registering `payload` callbacks into an empty list (the
+//   vector and the Signal are reused, so only the callbacks themselves may allocate); ns/op is per callback;
+// * register_disconnect/Signal: registering a callback and disconnecting it again by its handle, O(1) whatever
+//   the number of other callbacks.
+// Before the benchmarks, the heap allocations per registered callback are counted.
+// usage: ./a.out [--filter=<substring>] [--min_time=0.1] [--repetitions=3] [--payloads=1,10,100]
+//                [--json=results.json] [--context=commit=<hash>]
+#include <iostream>
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <vector>
+#include "../0x07-concurrency/benchSuite.hpp"
+#include "signal.hpp"
+
+std::atomic<long> allocations{0};
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// a handler with some state, like a UI callback that updates its own part of a model
+auto makeCallback(long* counter, long weight, long id) {
+    return [counter, weight, id] { *counter += weight * id; };
+}
+
+template <typename Register>
+double allocationsPerCallback(Register reg, size_t n) {
+    long before = allocations.load();
+    reg(n);
+    return static_cast<double>(allocations.load() - before) / static_cast<double>(n);
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        long total = 0;
+        const size_t n = 100;
+        std::vector<std::function<void()>> functions;
+        functions.reserve(n);
+        Signal<> signal;
+        signal.connect([] {}); // the Signal grows its vector here, the loop below only counts the callbacks
+        signal.disconnect(signal.connect([] {}));
+        std::cout << "heap allocations per registered callback: vector<std::function>: "
+                  << allocationsPerCallback([&](size_t k) {
+                         for (size_t i = 0; i < k; ++i) {
+                             functions.push_back(makeCallback(&total, 3, static_cast<long>(i)));
+                         }
+                     }, n)
+                  << ", Signal: " << allocationsPerCallback([&](size_t k) {
+                         for (size_t i = 0; i < k; ++i) {
+                             signal.disconnect(signal.connect(makeCallback(&total, 3, static_cast<long>(i))));
+                         }
+                     }, n)
+                  << std::endl;
+
+        bench::Suite suite;
+        suite.parseArgs(argc, argv);
+
+        suite.add("emit/vector_std_function", [](bench::Run& run) {
+            std::vector<long> counters(run.payload());
+            std::vector<std::function<void()>> callbacks;
+            for (size_t i = 0; i < run.payload(); ++i) {
+                callbacks.push_back(makeCallback(&counters[i], 3, static_cast<long>(i)));
+            }
+            run.parallel([&](size_t, size_t iterations) {
+                for (size_t i = 0; i < iterations; ++i) {
+                    for (const auto& callback : callbacks) {
+                        callback();
+                    }
+                }
+            });
+            bench::doNotOptimize(counters.data());
+        }).threads({1}).payload({1, 10, 100});
+
+        suite.add("emit/Signal", [](bench::Run& run) {
+            std::vector<long> counters(run.payload());
+            Signal<> callbacks;
+            for (size_t i = 0; i < run.payload(); ++i) {
+                callbacks.connect(makeCallback(&counters[i], 3, static_cast<long>(i)));
+            }
+            run.parallel([&](size_t, size_t iterations) {
+                for (size_t i = 0; i < iterations; ++i) {
+                    callbacks.emit();
+                }
+            });
+            bench::doNotOptimize(counters.data());
+        }).threads({1}).payload({1, 10, 100});
+
+        suite.add("register/vector_std_function", [](bench::Run& run) {
+            long sum = 0;
+            std::vector<std::function<void()>> callbacks;
+            callbacks.reserve(run.payload());
+            run.setItemsProcessed(run.iterations() * run.payload());
+            run.parallel([&](size_t, size_t iterations) {
+                for (size_t i = 0; i < iterations; ++i) {
+                    for (size_t k = 0; k < run.payload(); ++k) {
+                        callbacks.push_back(makeCallback(&sum, 3, static_cast<long>(k)));
+                    }
+                    callbacks.clear();
+                }
+            });
+        }).threads({1}).payload({1, 10, 100});
+
+        suite.add("register/Signal", [](bench::Run& run) {
+            long sum = 0;
+            Signal<> callbacks;
+            std::vector<Signal<>::Connection> connections(run.payload());
+            run.setItemsProcessed(run.iterations() * run.payload());
+            run.parallel([&](size_t, size_t iterations) {
+                for (size_t i = 0; i < iterations; ++i) {
+                    for (size_t k = 0; k < run.payload(); ++k) {
+                        connections[k] = callbacks.connect(makeCallback(&sum, 3, static_cast<long>(k)));
+                    }
+                    for (const auto& c : connections) {
+                        callbacks.disconnect(c);
+                    }
+                }
+            });
+        }).threads({1}).payload({1, 10, 100});
+
+        suite.add("register_disconnect/Signal", [](bench::Run& run) {
+            long sum = 0;
+            Signal<> callbacks;
+            for (size_t k = 0; k < run.payload(); ++k) {
+                callbacks.connect(makeCallback(&sum, 3, static_cast<long>(k)));
+            }
+            run.parallel([&](size_t, size_t iterations) {
+                for (size_t i = 0; i < iterations; ++i) {
+                    callbacks.disconnect(callbacks.connect(makeCallback(&sum, 3, static_cast<long>(i))));
+                }
+            });
+        }).threads({1}).payload({1, 10, 100});
+
+        suite.runAll();
+    } catch (const std::exception& e) {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
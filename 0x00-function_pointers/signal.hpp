@@ -0,0 +1,145 @@
+#ifndef SIGNAL_HPP
+#define SIGNAL_HPP
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "../0x07-concurrency/uniqueFunction.hpp"
+
+// Signal<Args...>: a list of callbacks ("slots") called in order by emit(args...), the event dispatcher behind
+// Button::press in 0x04-Callback_function.cpp.
+// * a slot is a UniqueFunction (../0x07-concurrency/uniqueFunction.hpp): a lambda capturing up to `InlineSize`
+//   bytes is stored in the slot itself, so connecting it does not allocate (std::function keeps only 16 bytes
+//   inline in libstdc++) and calling it is one indirect call through a function pointer;
+// * the slots live in one contiguous vector, emit() walks it in order;
+// * connect() returns a Connection {index, generation}: disconnect(c) is O(1), and a handle whose slot is gone
+//   (disconnected twice, or the index reused by a later connect) is recognized by its generation and ignored;
+// * a slot may connect or disconnect slots (itself included) while the signal is being emitted:
+//   - a slot disconnected during emit() is not called anymore, but it is only destroyed when the outermost
+//     emit() returns (it may be the one that is running);
+//   - a slot connected during emit() is put aside and appended when the outermost emit() returns: it is first
+//     called by the next emit(), and the vector is never reallocated under a running slot.
+// Not thread-safe: like Button, a Signal belongs to one thread (the UI thread).
+template <typename... Args>
+class Signal {
+public:
+    static constexpr size_t InlineSize = 4 * sizeof(void*);
+    using Slot = UniqueFunction<void(Args...), InlineSize>;
+
+    struct Connection {
+        uint32_t index = UINT32_MAX;
+        uint32_t generation = 0;
+    };
+
+private:
+    struct Entry {
+        Slot fn;
+        uint32_t generation = 0;
+        bool live = false;
+    };
+
+    std::vector<Entry> slots_;
+    std::vector<Entry> pending_;          // connected during emit(), they get the indices after slots_
+    std::vector<uint32_t> free_;          // dead entries of slots_, reused by connect()
+    std::vector<uint32_t> deferredFree_;  // disconnected during emit(), destroyed after it
+    uint32_t emitting_ = 0;               // nesting depth of emit()
+    size_t size_ = 0;
+
+    Entry* find(Connection c) {
+        Entry* e = nullptr;
+        if (c.index < slots_.size()) {
+            e = &slots_[c.index];
+        } else if (c.index - slots_.size() < pending_.size()) {
+            e = &pending_[c.index - slots_.size()];
+        }
+        return e && e->live && e->generation == c.generation ? e : nullptr;
+    }
+
+    // when the outermost emit() returns (or throws): destroy what was disconnected, append what was connected
+    void finishEmit() {
+        if (--emitting_ > 0 || (deferredFree_.empty() && pending_.empty())) {
+            return;
+        }
+        for (uint32_t index : deferredFree_) {
+            slots_[index].fn = Slot();
+            free_.push_back(index);
+        }
+        deferredFree_.clear();
+        for (Entry& e : pending_) {
+            slots_.push_back(std::move(e));
+            if (!slots_.back().live) {
+                free_.push_back(static_cast<uint32_t>(slots_.size() - 1));
+            }
+        }
+        pending_.clear();
+    }
+
+    struct EmitGuard {
+        Signal& signal;
+        ~EmitGuard() { signal.finishEmit(); }
+    };
+
+public:
+    Signal() = default;
+    Signal(const Signal&) = delete;
+    Signal& operator=(const Signal&) = delete;
+
+    Connection connect(Slot fn) {
+        Entry* e;
+        uint32_t index;
+        if (emitting_ == 0 && !free_.empty()) {
+            index = free_.back();
+            free_.pop_back();
+            e = &slots_[index];
+        } else if (emitting_ == 0) {
+            index = static_cast<uint32_t>(slots_.size());
+            e = &slots_.emplace_back();
+        } else {
+            index = static_cast<uint32_t>(slots_.size() + pending_.size());
+            e = &pending_.emplace_back();
+        }
+        e->fn = std::move(fn);
+        e->live = true;
+        ++size_;
+        return {index, e->generation};
+    }
+
+    // false if the connection was already gone
+    bool disconnect(Connection c) {
+        Entry* e = find(c);
+        if (!e) {
+            return false;
+        }
+        e->live = false;
+        ++e->generation; // every copy of the handle is stale from now on
+        --size_;
+        if (c.index >= slots_.size()) {
+            e->fn = Slot(); // a pending slot never ran: it can go now, its index is freed when it is appended
+        } else if (emitting_ > 0) {
+            deferredFree_.push_back(c.index);
+        } else {
+            e->fn = Slot();
+            free_.push_back(c.index);
+        }
+        return true;
+    }
+
+    bool connected(Connection c) { return find(c) != nullptr; }
+
+    size_t size() const { return size_; }
+
+    void emit(Args... args) {
+        ++emitting_;
+        EmitGuard guard{*this};
+        // slots_ does not grow during emit(): the slots connected meanwhile wait in pending_
+        for (size_t i = 0, n = slots_.size(); i < n; ++i) {
+            if (slots_[i].live) {
+                slots_[i].fn(args...);
+            }
+        }
+    }
+
+    void operator()(Args... args) { emit(std::forward<Args>(args)...); }
+};
+
+#endif // SIGNAL_HPP
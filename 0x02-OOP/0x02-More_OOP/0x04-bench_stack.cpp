@@ -0,0 +1,84 @@
+// Benchmarks for the stack of 0x01-templates_oop_interfaces.cpp (arrayStack.hpp, benchSuite.hpp): what the
+// interface costs. `payload` values are pushed and popped again, ns/op is per push+pop:
+// * stack/IStack_ref: through an IStack<int>&, so every call is virtual (the compiler can not see the object);
+// * stack/ArrayStack: the same object called directly, the calls can be devirtualized and inlined;
+// * stack/std_stack: std::stack<int, std::vector<int>>, no interface at all.
+// usage: ./a.out [--filter=<substring>] [--min_time=0.1] [--repetitions=3] [--payloads=16,1024]
+//                [--json=results.json] [--context=commit=<hash>]
+#include <iostream>
+#include <memory>
+#include <stack>
+#include <vector>
+#include "../../0x07-concurrency/benchSuite.hpp"
+#include "arrayStack.hpp"
+
+// the object behind the reference is chosen at run time, like a plugin would be
+std::unique_ptr<IStack<int>> makeStack(bool printable) {
+    if (printable) {
+        return std::make_unique<PrintableArrayStack<int>>();
+    }
+    return std::make_unique<ArrayStack<int>>();
+}
+
+template <typename Stack>
+long pushPop(Stack& s, size_t n) {
+    for (size_t k = 0; k < n; ++k) {
+        s.push(static_cast<int>(k));
+    }
+    long sum = 0;
+    while (!s.isEmpty()) {
+        sum += s.pop();
+    }
+    return sum;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        bench::Suite suite;
+        suite.parseArgs(argc, argv);
+
+        suite.add("stack/IStack_ref", [&](bench::Run& run) {
+            std::unique_ptr<IStack<int>> s = makeStack(argc > 1000);
+            run.setItemsProcessed(run.iterations() * run.payload());
+            run.parallel([&](size_t, size_t iterations) {
+                for (size_t i = 0; i < iterations; ++i) {
+                    bench::doNotOptimize(pushPop(*s, run.payload()));
+                }
+            });
+        }).threads({1}).payload({16, 1024});
+
+        suite.add("stack/ArrayStack", [](bench::Run& run) {
+            ArrayStack<int> s;
+            run.setItemsProcessed(run.iterations() * run.payload());
+            run.parallel([&](size_t, size_t iterations) {
+                for (size_t i = 0; i < iterations; ++i) {
+                    bench::doNotOptimize(pushPop(s, run.payload()));
+                }
+            });
+        }).threads({1}).payload({16, 1024});
+
+        suite.add("stack/std_stack", [](bench::Run& run) {
+            std::stack<int, std::vector<int>> s;
+            run.setItemsProcessed(run.iterations() * run.payload());
+            run.parallel([&](size_t, size_t iterations) {
+                for (size_t i = 0; i < iterations; ++i) {
+                    for (size_t k = 0; k < run.payload(); ++k) {
+                        s.push(static_cast<int>(k));
+                    }
+                    long sum = 0;
+                    while (!s.empty()) {
+                        sum += s.top();
+                        s.pop();
+                    }
+                    bench::doNotOptimize(sum);
+                }
+            });
+        }).threads({1}).payload({16, 1024});
+
+        suite.runAll();
+    } catch (const std::exception& e) {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,67 @@
+// Tests for the stack interface of 0x02-More_OOP (arrayStack.hpp): ArrayStack through IStack, and
+// PrintableArrayStack through both of its interfaces. Every check is an assert: the test target is compiled
+// without NDEBUG, whatever the build type.
+// usage: ./a.out
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include "../0x02-More_OOP/arrayStack.hpp"
+
+template <typename Fn>
+bool throwsOutOfRange(Fn fn) {
+    try {
+        fn();
+    } catch (const std::out_of_range&) {
+        return true;
+    }
+    return false;
+}
+
+void testArrayStack() {
+    std::unique_ptr<IStack<int>> s = std::make_unique<ArrayStack<int>>();
+    assert(s->isEmpty());
+    assert(throwsOutOfRange([&] { s->pop(); }));
+    assert(throwsOutOfRange([&] { s->peek(); }));
+
+    for (int i = 0; i < 100; ++i) {
+        s->push(i);
+        assert(s->peek() == i);
+    }
+    assert(!s->isEmpty());
+    for (int i = 99; i >= 0; --i) {
+        assert(s->pop() == i); // last in, first out
+    }
+    assert(s->isEmpty());
+    assert(throwsOutOfRange([&] { s->pop(); }));
+}
+
+void testPrintableArrayStack() {
+    PrintableArrayStack<std::string> stack;
+    IStack<std::string>& asStack = stack;
+    PrintableStack<std::string>& asPrintable = stack;
+    asStack.push("a");
+    asStack.push("b");
+    asPrintable.push("c"); // one IStack (virtual inheritance): both views share the elements
+    assert(asStack.peek() == "c" && asPrintable.peek() == "c");
+
+    std::ostringstream out;
+    std::streambuf* saved = std::cout.rdbuf(out.rdbuf());
+    asPrintable.print();
+    std::cout.rdbuf(saved);
+    assert(out.str() == "Stack contents: a b c \n");
+
+    assert(asPrintable.pop() == "c");
+    assert(asStack.pop() == "b");
+    assert(stack.pop() == "a");
+    assert(stack.isEmpty() && asPrintable.isEmpty());
+}
+
+int main() {
+    testArrayStack();
+    testPrintableArrayStack();
+    std::cout << "test_oop: all tests passed" << std::endl;
+    return 0;
+}
@@ -59,5 +59,12 @@ int main()
     std::cout << "v10.getSize(): " << v10.getSize() << std::endl;
     std::cout << "v10 = ";
     v10.print();
+    // 11. push_back: the capacity doubles each time it is full (resize)
+    MyVector<int> v11;
+    for (int i = 0; i < 100000; i++) {
+        v11.push_back(i);
+    }
+    std::cout << "v11.getSize(): " << v11.getSize() << std::endl;
+    INSTRUMENT_REPORT(std::cout);
     return 0;
 }
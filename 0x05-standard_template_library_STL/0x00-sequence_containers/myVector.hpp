@@ -3,6 +3,7 @@
 
 #include <iostream>
 #include <stdexcept>
+#include "../../0x07-concurrency/scopedTimer.hpp"
 
 template <typename T>
 class MyVector {
@@ -172,6 +173,7 @@ void MyVector<T>::print() {
 
 template <typename T>
 void MyVector<T>::resize() {
+    SCOPED_TIMER("MyVector::resize");
     capacity *= 2;
     T* newData = new T[capacity];
     for (size_t i = 0; i < size; i++) {
@@ -0,0 +1,88 @@
+#ifndef ALLOC_VECTOR_HPP
+#define ALLOC_VECTOR_HPP
+
+#include <memory>  // For std::allocator, std::allocator_traits
+#include <stdexcept> // For std::out_of_range
+#include <utility>
+
+// An allocator-aware vector: the memory comes from `Alloc` (std::allocator by default), and the elements are
+// constructed and destroyed in that memory through std::allocator_traits. allocator.construct() and
+// allocator.destroy() were removed from std::allocator in C++20; the traits call them when the allocator has
+// them, and fall back to placement new and ~T() otherwise.
+template <typename T, typename Alloc = std::allocator<T>>
+class AllocVector {
+public:
+    // type aliases
+    using size_type = std::size_t;
+    using value_type = T;
+    using traits = std::allocator_traits<Alloc>;
+
+    // default constructor
+    AllocVector() : size_(0), capacity_(1) {
+        // Allocate memory for the vector
+        // allocates uninitialized storage
+        data_ = traits::allocate(allocator_, capacity_); // using allocator for handling memory management
+    }
+
+    AllocVector(const AllocVector&) = delete;
+    AllocVector& operator=(const AllocVector&) = delete;
+
+    // destructor
+    ~AllocVector() {
+        clear();
+        traits::deallocate(allocator_, data_, capacity_); // deallocates storage
+    }
+
+    // push_back
+    void push_back(const T& value) {
+        if (size_ == capacity_) {
+            resize(capacity_ * 2);
+        }
+        traits::construct(allocator_, data_ + size_, value); // constructs an object in allocated storage
+        ++size_;
+    }
+
+    // operator[] overload
+    T& operator[](size_type index) {
+        if (index >= size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        return data_[index];
+    }
+
+    const T& operator[](size_type index) const {
+        if (index >= size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        return data_[index];
+    }
+
+    size_type size() const { return size_; }
+
+    void clear() {
+        for (size_type i = 0; i < size_; ++i) {
+            traits::destroy(allocator_, data_ + i);
+        }
+        size_ = 0;
+    }
+
+private:
+    void resize(size_type new_capacity) {
+        T* new_data = traits::allocate(allocator_, new_capacity); // allocates uninitialized storage
+        for (size_type i = 0; i < size_; ++i) {
+            traits::construct(allocator_, new_data + i, std::move(data_[i])); // constructs an object in allocated storage
+            // std::move(data_[i]); for transfering ownership
+            traits::destroy(allocator_, data_ + i); // destructs an object in allocated storage
+        }
+        traits::deallocate(allocator_, data_, capacity_); // deallocates storage
+        data_ = new_data;
+        capacity_ = new_capacity;
+    }
+
+    Alloc allocator_; // Allocator instance
+    T* data_;
+    size_type size_;
+    size_type capacity_;
+};
+
+#endif // ALLOC_VECTOR_HPP
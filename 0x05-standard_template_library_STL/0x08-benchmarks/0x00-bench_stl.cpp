@@ -0,0 +1,162 @@
+// Benchmarks for the containers of this module and the algorithm demos of 0x05-Algorithms (benchSuite.hpp).
+// The containers are not shared between threads, so every benchmark runs on one thread; `payload` is the number
+// of elements, and ns/op is per element:
+// * push_back/MyVector, push_back/AllocVector, push_back/std_vector: a fresh vector filled with `payload` ints by
+//   push_back (MyVector of 0x00-sequence_containers, the allocator-aware vector of 0x07-allocators);
+// * iterate/MyArray, iterate/std_vector: summing `payload` ints through the iterator of 0x03-Iterators;
+// * algorithm/sort, algorithm/nth_element, algorithm/partition, algorithm/transform: the calls of the
+//   0x05-Algorithms examples on `payload` random ints (the input is copied back before every call).
+// usage: ./a.out [--filter=<substring>] [--min_time=0.1] [--repetitions=3] [--payloads=1000,100000]
+//                [--json=results.json] [--context=commit=<hash>]
+#include <iostream>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <vector>
+#include "../../0x07-concurrency/benchSuite.hpp"
+#include "../0x00-sequence_containers/myVector.hpp"
+#include "../0x03-Iterators/0x03-myArray.hpp"
+#include "../0x07-allocators/allocVector.hpp"
+
+// MyVector prints from its constructors and destructor; this keeps those lines out of the results
+class QuietCout {
+private:
+    std::ostringstream sink;
+    std::streambuf* saved;
+
+public:
+    QuietCout() : saved(std::cout.rdbuf(sink.rdbuf())) {}
+    ~QuietCout() { std::cout.rdbuf(saved); }
+};
+
+// at most 46340: algorithm/transform squares them, and 46341 * 46341 overflows an int
+std::vector<int> randomInts(size_t n) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> dist(0, 46340);
+    std::vector<int> v(n);
+    for (int& x : v) {
+        x = dist(rng);
+    }
+    return v;
+}
+
+// times fn(data) on a fresh copy of `input` for every iteration; one op is one element
+template <typename Fn>
+void timeAlgorithm(bench::Run& run, Fn fn) {
+    std::vector<int> input = randomInts(run.payload());
+    std::vector<int> data(input.size());
+    run.setItemsProcessed(run.iterations() * run.payload());
+    run.parallel([&](size_t, size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+            std::copy(input.begin(), input.end(), data.begin());
+            fn(data);
+            bench::doNotOptimize(data.data());
+        }
+    });
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        bench::Suite suite;
+        suite.parseArgs(argc, argv);
+
+        suite.add("push_back/MyVector", [](bench::Run& run) {
+            QuietCout quiet;
+            run.setItemsProcessed(run.iterations() * run.payload());
+            run.parallel([&](size_t, size_t iterations) {
+                for (size_t i = 0; i < iterations; ++i) {
+                    MyVector<int> v;
+                    for (size_t k = 0; k < run.payload(); ++k) {
+                        v.push_back(static_cast<int>(k));
+                    }
+                    bench::doNotOptimize(v[0]);
+                }
+            });
+        }).threads({1}).payload({1000, 100000});
+
+        suite.add("push_back/AllocVector", [](bench::Run& run) {
+            run.setItemsProcessed(run.iterations() * run.payload());
+            run.parallel([&](size_t, size_t iterations) {
+                for (size_t i = 0; i < iterations; ++i) {
+                    AllocVector<int> v;
+                    for (size_t k = 0; k < run.payload(); ++k) {
+                        v.push_back(static_cast<int>(k));
+                    }
+                    bench::doNotOptimize(v[0]);
+                }
+            });
+        }).threads({1}).payload({1000, 100000});
+
+        suite.add("push_back/std_vector", [](bench::Run& run) {
+            run.setItemsProcessed(run.iterations() * run.payload());
+            run.parallel([&](size_t, size_t iterations) {
+                for (size_t i = 0; i < iterations; ++i) {
+                    std::vector<int> v;
+                    for (size_t k = 0; k < run.payload(); ++k) {
+                        v.push_back(static_cast<int>(k));
+                    }
+                    bench::doNotOptimize(v[0]);
+                }
+            });
+        }).threads({1}).payload({1000, 100000});
+
+        suite.add("iterate/MyArray", [](bench::Run& run) {
+            MyArray<int> arr(run.payload());
+            for (size_t k = 0; k < run.payload(); ++k) {
+                arr[k] = static_cast<int>(k);
+            }
+            run.setItemsProcessed(run.iterations() * run.payload());
+            run.parallel([&](size_t, size_t iterations) {
+                for (size_t i = 0; i < iterations; ++i) {
+                    long sum = 0;
+                    for (auto it = arr.begin(); it != arr.end(); ++it) {
+                        sum += *it;
+                    }
+                    bench::doNotOptimize(sum);
+                }
+            });
+        }).threads({1}).payload({1000, 100000});
+
+        suite.add("iterate/std_vector", [](bench::Run& run) {
+            std::vector<int> v(run.payload());
+            std::iota(v.begin(), v.end(), 0);
+            run.setItemsProcessed(run.iterations() * run.payload());
+            run.parallel([&](size_t, size_t iterations) {
+                for (size_t i = 0; i < iterations; ++i) {
+                    long sum = 0;
+                    for (auto it = v.begin(); it != v.end(); ++it) {
+                        sum += *it;
+                    }
+                    bench::doNotOptimize(sum);
+                }
+            });
+        }).threads({1}).payload({1000, 100000});
+
+        suite.add("algorithm/sort", [](bench::Run& run) {
+            timeAlgorithm(run, [](std::vector<int>& v) { std::sort(v.begin(), v.end()); });
+        }).threads({1}).payload({1000, 100000});
+
+        suite.add("algorithm/nth_element", [](bench::Run& run) {
+            timeAlgorithm(run, [](std::vector<int>& v) { std::nth_element(v.begin(), v.begin() + v.size() / 2, v.end()); });
+        }).threads({1}).payload({1000, 100000});
+
+        suite.add("algorithm/partition", [](bench::Run& run) {
+            timeAlgorithm(run, [](std::vector<int>& v) {
+                std::partition(v.begin(), v.end(), [](int x) { return x % 2 == 0; });
+            });
+        }).threads({1}).payload({1000, 100000});
+
+        suite.add("algorithm/transform", [](bench::Run& run) {
+            timeAlgorithm(run, [](std::vector<int>& v) {
+                std::transform(v.begin(), v.end(), v.begin(), [](int x) { return x * x; });
+            });
+        }).threads({1}).payload({1000, 100000});
+
+        suite.runAll();
+    } catch (const std::exception& e) {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
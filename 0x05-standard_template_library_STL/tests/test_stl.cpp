@@ -0,0 +1,165 @@
+// Tests for the containers of this module: MyVector (0x00-sequence_containers), MyArray and its iterator
+// (0x03-Iterators) and AllocVector (0x07-allocators). Every check is an assert: the test target is compiled
+// without NDEBUG, whatever the build type.
+// usage: ./a.out
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include "../0x00-sequence_containers/myVector.hpp"
+#include "../0x03-Iterators/0x03-myArray.hpp"
+#include "../0x07-allocators/allocVector.hpp"
+
+// MyVector prints from its constructors and destructor; this keeps those lines out of the test output
+class QuietCout {
+private:
+    std::ostringstream sink;
+    std::streambuf* saved;
+
+public:
+    QuietCout() : saved(std::cout.rdbuf(sink.rdbuf())) {}
+    ~QuietCout() { std::cout.rdbuf(saved); }
+    std::string text() const { return sink.str(); }
+};
+
+void testMyVector() {
+    QuietCout quiet;
+    MyVector<int> v;
+    for (int i = 0; i < 1000; ++i) {
+        v.push_back(i); // grows 1, 2, 4, ... 1024
+    }
+    assert(v.getSize() == 1000);
+    for (int i = 0; i < 1000; ++i) {
+        assert(v[i] == i);
+    }
+    assert(v.at(999) == 999);
+    bool thrown = false;
+    try {
+        v.at(1000);
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    MyVector<int> filled(3, 7);
+    assert(filled.getSize() == 3 && filled[0] == 7 && filled[2] == 7);
+    MyVector<int> zeros(4);
+    assert(zeros.getSize() == 4 && zeros[3] == 0);
+
+    MyVector<int> list{1, 2, 3};
+    MyVector<int> copy(list);
+    copy[0] = 10;
+    assert(list[0] == 1 && copy[0] == 10 && copy.getSize() == 3);
+    copy.push_back(4); // the copy has its own buffer
+    assert(copy.getSize() == 4 && list.getSize() == 3);
+
+    MyVector<int> moved(std::move(copy));
+    assert(moved.getSize() == 4 && moved[3] == 4 && copy.getSize() == 0);
+
+    MyVector<int> assigned;
+    assigned = list;
+    assert(assigned.getSize() == 3 && assigned[2] == 3);
+    assigned = assigned; // self-assignment keeps the elements
+    assert(assigned.getSize() == 3 && assigned[1] == 2);
+    assigned = std::move(moved);
+    assert(assigned.getSize() == 4 && assigned[0] == 10 && moved.getSize() == 0);
+
+    std::ostringstream printed;
+    {
+        std::streambuf* saved = std::cout.rdbuf(printed.rdbuf());
+        list.print();
+        std::cout.rdbuf(saved);
+    }
+    assert(printed.str() == "1 2 3 \n");
+}
+
+void testMyArray() {
+    MyArray<int> a(100);
+    assert(a.arrCapacity() == 100);
+    for (size_t i = 0; i < a.arrCapacity(); ++i) {
+        a[i] = static_cast<int>(i);
+    }
+    int sum = 0;
+    size_t count = 0;
+    for (int x : a) {
+        sum += x;
+        ++count;
+    }
+    assert(count == 100 && sum == 4950);
+
+    auto it = a.begin();
+    auto old = it++;
+    assert(*old == 0 && *it == 1);
+    assert(*++it == 2);
+    *it = 42;
+    assert(a[2] == 42);
+}
+
+// counts the objects alive, to check that AllocVector destroys what it constructs
+struct Tracked {
+    static inline int alive = 0;
+    std::string value;
+    explicit Tracked(std::string v) : value(std::move(v)) { ++alive; }
+    Tracked(const Tracked& other) : value(other.value) { ++alive; }
+    Tracked(Tracked&& other) noexcept : value(std::move(other.value)) { ++alive; }
+    ~Tracked() { --alive; }
+};
+
+// std::allocator that counts the elements it hands out
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+    static inline long allocated = 0;
+    CountingAllocator() = default;
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&) {}
+    T* allocate(size_t n) {
+        allocated += static_cast<long>(n);
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T* p, size_t n) {
+        allocated -= static_cast<long>(n);
+        std::allocator<T>().deallocate(p, n);
+    }
+    friend bool operator==(const CountingAllocator&, const CountingAllocator&) { return true; }
+};
+
+void testAllocVector() {
+    {
+        AllocVector<Tracked, CountingAllocator<Tracked>> v;
+        for (int i = 0; i < 100; ++i) {
+            v.push_back(Tracked(std::to_string(i)));
+        }
+        assert(v.size() == 100);
+        assert(Tracked::alive == 100); // the temporaries and the moved-from elements are gone
+        assert(v[0].value == "0" && v[99].value == "99");
+        const auto& cv = v;
+        assert(cv[50].value == "50");
+        bool thrown = false;
+        try {
+            v[100];
+        } catch (const std::out_of_range&) {
+            thrown = true;
+        }
+        assert(thrown);
+        assert(CountingAllocator<Tracked>::allocated == 128); // the current capacity, the old buffers are freed
+
+        v.clear();
+        assert(v.size() == 0 && Tracked::alive == 0);
+        v.push_back(Tracked("again"));
+        assert(v.size() == 1 && v[0].value == "again");
+    }
+    assert(Tracked::alive == 0);
+    assert(CountingAllocator<Tracked>::allocated == 0);
+}
+
+int main() {
+    testMyVector();
+    testMyArray();
+    testAllocVector();
+    std::cout << "test_stl: all tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,121 @@
+// Intrusive reference counting vs std::shared_ptr
+// std::shared_ptr keeps the counter in a separate control block and updates it atomically (libstdc++ skips the atomics only while the program has a single thread).
+// IntrusivePtr keeps the counter inside the object, and we choose atomic or non-atomic counting at compile time.
+// This program benchmarks copy/destroy throughput on a pointer-chasing graph workload.
+// usage: ./a.out [number_of_nodes] [number_of_steps]
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <random>
+#include <numeric>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include "intrusivePtr.hpp"
+
+// The three node types carry the same payload, only the ownership mechanism is different.
+struct SharedNode {
+    size_t next = 0; // index of the next node in the walk
+    long value = 0;
+};
+
+struct LocalNode : RefCounted<LocalNode> { // non-atomic counter (single thread only)
+    size_t next = 0;
+    long value = 0;
+};
+
+struct AtomicNode : RefCounted<AtomicNode, AtomicRefCount> { // atomic counter (may be shared across threads)
+    size_t next = 0;
+    long value = 0;
+};
+
+template <typename Ptr>
+struct Graph {
+    std::vector<Ptr> nodes; // the graph owns every node
+};
+
+// Builds one random cycle through all the nodes, so the walk jumps all over the memory.
+template <typename Ptr, typename MakeFn>
+Graph<Ptr> buildGraph(size_t n, MakeFn make) {
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), std::mt19937_64(42));
+
+    Graph<Ptr> g;
+    g.nodes.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        g.nodes.push_back(make());
+        g.nodes.back()->value = static_cast<long>(i);
+    }
+    for (size_t i = 0; i < n; ++i) {
+        g.nodes[order[i]]->next = order[(i + 1) % n];
+    }
+    return g;
+}
+
+// Every step copies a pointer out of the graph (increment) and drops the previous one (decrement).
+template <typename Ptr>
+long walk(const Graph<Ptr>& g, size_t steps) {
+    Ptr cur = g.nodes[0];
+    long sum = 0;
+    for (size_t i = 0; i < steps; ++i) {
+        cur = g.nodes[cur->next];
+        sum += cur->value;
+    }
+    return sum;
+}
+
+// Copies all the pointers into a new vector and destroys it again.
+template <typename Ptr>
+size_t copyAll(const Graph<Ptr>& g, int rounds) {
+    size_t total = 0;
+    for (int r = 0; r < rounds; ++r) {
+        std::vector<Ptr> copy(g.nodes);
+        total += copy.size();
+    }
+    return total;
+}
+
+template <typename Ptr, typename MakeFn>
+void runBenchmark(const std::string& name, size_t n, size_t steps, MakeFn make) {
+    using clock = std::chrono::steady_clock;
+
+    auto t0 = clock::now();
+    Graph<Ptr> g = buildGraph<Ptr>(n, make);
+    auto t1 = clock::now();
+    long sum = walk(g, steps);
+    auto t2 = clock::now();
+    size_t copied = copyAll(g, 10);
+    auto t3 = clock::now();
+
+    auto ns = [](auto d) { return std::chrono::duration<double, std::nano>(d).count(); };
+    std::cout << name << ":\n"
+              << "  build:        " << ns(t1 - t0) / n << " ns/node\n"
+              << "  walk:         " << ns(t2 - t1) / steps << " ns/step (checksum " << sum << ")\n"
+              << "  copy+destroy: " << ns(t3 - t2) / copied << " ns/pointer\n";
+}
+
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 1'000'000;
+    size_t steps = argc > 2 ? std::stoul(argv[2]) : 10'000'000;
+
+    std::cout << "nodes: " << n << ", steps: " << steps << "\n";
+
+    // make_shared allocates the object and the control block together, this is the best case for shared_ptr
+    runBenchmark<std::shared_ptr<SharedNode>>("std::shared_ptr (make_shared)", n, steps,
+        [] { return std::make_shared<SharedNode>(); });
+    runBenchmark<IntrusivePtr<AtomicNode>>("IntrusivePtr<AtomicRefCount>", n, steps,
+        [] { return make_intrusive<AtomicNode>(); });
+    runBenchmark<IntrusivePtr<LocalNode>>("IntrusivePtr<NonAtomicRefCount>", n, steps,
+        [] { return make_intrusive<LocalNode>(); });
+
+    // the counter is part of the object, so the pointer is just one raw pointer
+    std::cout << "sizeof(std::shared_ptr<T>) = " << sizeof(std::shared_ptr<SharedNode>) << "\n";
+    std::cout << "sizeof(IntrusivePtr<T>)    = " << sizeof(IntrusivePtr<LocalNode>) << "\n";
+
+    // and a raw pointer can always be turned back into an owning pointer
+    IntrusivePtr<LocalNode> a = make_intrusive<LocalNode>();
+    IntrusivePtr<LocalNode> b(a.get());
+    std::cout << "use_count after re-adopting a raw pointer: " << a.use_count() << "\n"; // 2
+    return 0;
+}
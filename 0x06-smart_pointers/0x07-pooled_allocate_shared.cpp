@@ -0,0 +1,119 @@
+// Pooled std::allocate_shared
+// std::make_shared and std::shared_ptr(new X, deleter) both go to the global heap (the deleter form twice:
+// once for the object and once for the control block).
+// With a pool allocator, freed objects and control blocks go back to a thread-local free list and
+// the next allocation reuses them without calling malloc.
+// usage: ./a.out [number_of_nodes_per_thread] [number_of_threads]
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <cstdlib>
+#include <new>
+#include "poolAllocator.hpp"
+
+// Count every call to the global operator new, so we can see how many times we hit the heap.
+std::atomic<size_t> heapAllocations{0};
+
+void* operator new(size_t size) {
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+// the pool allocates its chunks with the aligned form
+void* operator new(size_t size, std::align_val_t align) {
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    size_t a = static_cast<size_t>(align);
+    if (void* p = std::aligned_alloc(a, (size + a - 1) / a * a)) { // size must be a multiple of the alignment
+        return p;
+    }
+    throw std::bad_alloc();
+}
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+struct GraphNode {
+    long id;
+    std::shared_ptr<GraphNode> next;
+    explicit GraphNode(long i) : id(i) {}
+};
+
+class Resource {
+public:
+    int value = 0;
+};
+
+// Custom deleter (same shape as in 0x02-shared_ptr.cpp), but the object goes back to the pool
+void customPoolDeleter(Resource* res) {
+    // ... any custom cleanup ...
+    pool_delete(res);
+}
+
+// Creates short chains of nodes and drops them again, `n` nodes in total.
+template <typename MakeFn>
+long churn(size_t n, MakeFn make) {
+    long sum = 0;
+    for (size_t i = 0; i < n; i += 4) {
+        std::shared_ptr<GraphNode> head = make(static_cast<long>(i));
+        head->next = make(static_cast<long>(i + 1));
+        head->next->next = make(static_cast<long>(i + 2));
+        head->next->next->next = make(static_cast<long>(i + 3));
+        sum += head->next->next->next->id;
+    } // the chain is destroyed here
+    return sum;
+}
+
+template <typename Fn>
+void runBenchmark(const std::string& name, size_t n, int threads, Fn fn) {
+    size_t before = heapAllocations.load();
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back(fn);
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    size_t allocations = heapAllocations.load() - before; // includes the thread start-up
+    double total = static_cast<double>(n) * threads;
+    std::cout << name << ": " << total / elapsed / 1e6 << " M objects/s, "
+              << allocations << " heap allocations\n";
+}
+
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 4'000'000;
+    int threads = argc > 2 ? std::stoi(argv[2]) : 4;
+
+    std::cout << threads << " threads, " << n << " objects per thread\n";
+
+    runBenchmark("std::make_shared                   ", n, threads, [n] {
+        churn(n, [](long i) { return std::make_shared<GraphNode>(i); });
+    });
+    runBenchmark("make_pooled_shared                 ", n, threads, [n] {
+        churn(n, [](long i) { return make_pooled_shared<GraphNode>(i); });
+    });
+
+    runBenchmark("shared_ptr(new Resource, deleter)  ", n, threads, [n] {
+        for (size_t i = 0; i < n; ++i) {
+            std::shared_ptr<Resource> sp(new Resource, [](Resource* r) { delete r; });
+            sp->value = 1;
+        }
+    });
+    runBenchmark("pooled_shared_with_deleter         ", n, threads, [n] {
+        for (size_t i = 0; i < n; ++i) {
+            std::shared_ptr<Resource> sp = pooled_shared_with_deleter(pool_new<Resource>(), customPoolDeleter);
+            sp->value = 1;
+        }
+    });
+    return 0;
+}
@@ -0,0 +1,96 @@
+// Zero-copy file reading with mmap
+// 0x05-custom_deleters.cpp reads a file descriptor through a 256-byte stack buffer, one read() at a time:
+// one system call and one copy (page cache -> buffer) every 256 bytes.
+// MappedFile maps the whole file and gives it to the parser as a std::span<const std::byte>.
+// This program scans a file (counting the lines) with the three approaches and prints the throughput.
+// usage: ./a.out [file_size_in_MB] [file_path]
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <algorithm>
+#include <stdexcept>
+#include "uniqueFd.hpp"
+#include "mappedFile.hpp"
+
+// Writes `megabytes` of text lines to `path`.
+void createFile(const std::string& path, size_t megabytes) {
+    UniqueFd fd = UniqueFd::open(path, O_WRONLY | O_CREAT | O_TRUNC);
+    std::string block;
+    while (block.size() < (1 << 20) - 64) {
+        block += "some,comma,separated,values,in,a,dataset,line," + std::to_string(block.size()) + "\n";
+    }
+    block.resize(1 << 20, '#');
+    for (size_t i = 0; i < megabytes; ++i) {
+        if (write(fd.get(), block.data(), block.size()) != static_cast<ssize_t>(block.size())) {
+            throw std::runtime_error("Error writing to file.");
+        }
+    }
+}
+
+size_t countLines(const char* data, size_t size) {
+    return static_cast<size_t>(std::count(data, data + size, '\n'));
+}
+
+// the current approach: a small stack buffer
+size_t scanWithRead256(const std::string& path) {
+    UniqueFd fd = UniqueFd::open(path, O_RDONLY);
+    char buffer[256];
+    size_t lines = 0;
+    ssize_t bytes_read;
+    while ((bytes_read = read(fd.get(), buffer, sizeof(buffer))) > 0) {
+        lines += countLines(buffer, static_cast<size_t>(bytes_read));
+    }
+    return lines;
+}
+
+// the same loop with a bigger buffer: fewer system calls, but still one copy
+size_t scanWithRead1MB(const std::string& path) {
+    UniqueFd fd = UniqueFd::open(path, O_RDONLY);
+    std::vector<char> buffer(1 << 20);
+    size_t lines = 0;
+    ssize_t bytes_read;
+    while ((bytes_read = read(fd.get(), buffer.data(), buffer.size())) > 0) {
+        lines += countLines(buffer.data(), static_cast<size_t>(bytes_read));
+    }
+    return lines;
+}
+
+// no copy at all
+size_t scanWithMmap(const std::string& path) {
+    MappedFile file(path, MappedFile::Access::sequential);
+    std::span<const std::byte> bytes = file.bytes();
+    return countLines(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+
+template <typename Fn>
+void runBenchmark(const std::string& name, const std::string& path, size_t megabytes, Fn scan) {
+    auto start = std::chrono::steady_clock::now();
+    size_t lines = scan(path);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name << ": " << megabytes / seconds << " MB/s (" << lines << " lines)\n";
+}
+
+int main(int argc, char* argv[]) {
+    size_t megabytes = argc > 1 ? std::stoul(argv[1]) : 2048;
+    std::string path = argc > 2 ? argv[2] : "mapped_file_example.txt";
+
+    try {
+        createFile(path, megabytes);
+
+        // the first scan brings the file into the page cache, so every approach is measured with a warm cache
+        scanWithRead1MB(path);
+
+        runBenchmark("read() 256 B buffer", path, megabytes, scanWithRead256);
+        runBenchmark("read() 1 MB buffer ", path, megabytes, scanWithRead1MB);
+        runBenchmark("MappedFile (mmap)  ", path, megabytes, scanWithMmap);
+    } catch (const std::exception& ex) {
+        std::cerr << "Exception: " << ex.what() << "\n";
+        std::remove(path.c_str());
+        return 1;
+    }
+
+    std::remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,544 @@
+#ifndef ASYNC_FILE_IO_HPP
+#define ASYNC_FILE_IO_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "uniqueFd.hpp"
+
+// Asynchronous file reads and writes.
+// A blocking read() parks the calling thread until the data is there. With AsyncFileEngine the caller queues
+// requests, submits them as one batch, and gets the result through a callback or a std::future.
+// Two backends:
+// * io_uring (Linux >= 5.6): one system call submits the whole batch, and a single completion thread runs
+//   the callbacks. Buffers can be registered once so the kernel does not have to map them for every request.
+// * a thread pool calling pread()/pwrite(), used when io_uring is not available (old kernel, seccomp, ...).
+//
+// The callbacks run on the engine's threads, so they must be short (hand heavy work over to another queue).
+// They may queue new requests: on io_uring, one queued while the ring is full is submitted by the completion
+// thread once the callbacks of its batch have returned, instead of blocking it.
+// The result is the number of bytes transferred, or -errno.
+
+struct IoRequest {
+    enum class Op { read, write };
+    Op op;
+    int fd;
+    void* buf;
+    size_t len;
+    off_t offset;
+    int bufIndex; // registered buffer, or -1
+    std::function<void(ssize_t)> done;
+};
+
+class IoBackend {
+public:
+    virtual ~IoBackend() = default;
+    virtual bool registerBuffers(const std::vector<std::span<std::byte>>& buffers) = 0;
+    virtual void enqueue(IoRequest request) = 0; // queued, not submitted yet
+    virtual void submit() = 0;                   // submits every queued request
+};
+
+// Minimal io_uring wrapper using the raw system calls (no liburing dependency).
+class IoUring {
+private:
+    UniqueFd ringFd_;
+    void* sqRing_ = MAP_FAILED;
+    size_t sqRingSize_ = 0;
+    void* cqRing_ = MAP_FAILED;
+    size_t cqRingSize_ = 0;
+    io_uring_sqe* sqes_ = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t sqesSize_ = 0;
+
+    // pointers into the shared rings
+    unsigned* sqHead_ = nullptr;
+    unsigned* sqTail_ = nullptr;
+    unsigned* sqArray_ = nullptr;
+    unsigned sqMask_ = 0;
+    unsigned* cqHead_ = nullptr;
+    unsigned* cqTail_ = nullptr;
+    io_uring_cqe* cqes_ = nullptr;
+    unsigned cqMask_ = 0;
+
+    unsigned sqEntries_ = 0;
+    unsigned localTail_ = 0; // next free sqe (not yet visible to the kernel)
+
+    static unsigned loadAcquire(const unsigned* p) { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+    static void storeRelease(unsigned* p, unsigned v) { __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+
+public:
+    // throws std::system_error if the kernel does not support io_uring
+    explicit IoUring(unsigned entries) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        int fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "io_uring_setup");
+        }
+        ringFd_.reset(fd);
+        sqEntries_ = params.sq_entries;
+
+        sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (singleMmap) {
+            sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+        }
+
+        sqRing_ = ::mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         fd, IORING_OFF_SQ_RING);
+        if (sqRing_ == MAP_FAILED) {
+            throw std::system_error(errno, std::generic_category(), "mmap io_uring sq ring");
+        }
+        if (singleMmap) {
+            cqRing_ = sqRing_;
+        } else {
+            cqRing_ = ::mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                             fd, IORING_OFF_CQ_RING);
+            if (cqRing_ == MAP_FAILED) {
+                int err = errno;
+                ::munmap(sqRing_, sqRingSize_);
+                throw std::system_error(err, std::generic_category(), "mmap io_uring cq ring");
+            }
+        }
+        sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = ::mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                            fd, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) {
+            int err = errno;
+            unmapRings();
+            throw std::system_error(err, std::generic_category(), "mmap io_uring sqes");
+        }
+        sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+        char* sq = static_cast<char*>(sqRing_);
+        sqHead_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        char* cq = static_cast<char*>(cqRing_);
+        cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        localTail_ = *sqTail_;
+    }
+
+    ~IoUring() {
+        if (sqes_ != MAP_FAILED) {
+            ::munmap(sqes_, sqesSize_);
+        }
+        unmapRings();
+    }
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    void unmapRings() {
+        if (cqRing_ != MAP_FAILED && cqRing_ != sqRing_) {
+            ::munmap(cqRing_, cqRingSize_);
+        }
+        if (sqRing_ != MAP_FAILED) {
+            ::munmap(sqRing_, sqRingSize_);
+        }
+        sqRing_ = cqRing_ = MAP_FAILED;
+    }
+
+    unsigned entries() const { return sqEntries_; }
+
+    // returns a zeroed sqe, or nullptr if the submission queue is full
+    io_uring_sqe* getSqe() {
+        if (localTail_ - loadAcquire(sqHead_) >= sqEntries_) {
+            return nullptr;
+        }
+        unsigned index = localTail_ & sqMask_;
+        sqArray_[index] = index;
+        ++localTail_;
+        std::memset(&sqes_[index], 0, sizeof(io_uring_sqe));
+        return &sqes_[index];
+    }
+
+    // makes the new sqes visible to the kernel and submits them (waits for `minComplete` completions)
+    int enter(unsigned minComplete) {
+        storeRelease(sqTail_, localTail_);
+        unsigned toSubmit = localTail_ - loadAcquire(sqHead_); // everything the kernel did not consume yet
+        unsigned flags = minComplete > 0 ? IORING_ENTER_GETEVENTS : 0;
+        int ret;
+        do {
+            ret = static_cast<int>(::syscall(__NR_io_uring_enter, ringFd_.get(), toSubmit, minComplete,
+                                             flags, nullptr, 0));
+        } while (ret < 0 && errno == EINTR);
+        return ret < 0 ? -errno : ret;
+    }
+
+    // waits for at least one completion without submitting anything (used by the completion thread)
+    int waitCompletion() {
+        int ret;
+        do {
+            ret = static_cast<int>(::syscall(__NR_io_uring_enter, ringFd_.get(), 0, 1,
+                                             IORING_ENTER_GETEVENTS, nullptr, 0));
+        } while (ret < 0 && errno == EINTR);
+        return ret < 0 ? -errno : ret;
+    }
+
+    // calls fn(cqe) for every available completion
+    template <typename Fn>
+    unsigned drainCompletions(Fn fn) {
+        unsigned head = *cqHead_;
+        unsigned tail = loadAcquire(cqTail_);
+        unsigned count = 0;
+        for (; head != tail; ++head, ++count) {
+            fn(cqes_[head & cqMask_]);
+        }
+        storeRelease(cqHead_, head);
+        return count;
+    }
+
+    bool registerBuffers(const std::vector<iovec>& iovecs) {
+        int ret = static_cast<int>(::syscall(__NR_io_uring_register, ringFd_.get(), IORING_REGISTER_BUFFERS,
+                                             iovecs.data(), static_cast<unsigned>(iovecs.size())));
+        return ret == 0;
+    }
+};
+
+class IoUringBackend : public IoBackend {
+private:
+    IoUring ring_;
+    std::mutex mtx_;              // protects the submission queue
+    std::condition_variable cv_;  // signaled when a request completes
+    unsigned inFlight_ = 0;       // never more than the queue depth, so the completion queue can not overflow
+    // requests queued by the callbacks while the ring was full: the reaper can not wait for a free slot (only
+    // it frees them), it submits these after its callbacks return
+    std::deque<std::unique_ptr<IoRequest>> overflow_;
+    bool reaping_ = false;        // the reaper has callbacks to run, they may still queue requests
+    bool stopping_ = false;
+    std::thread reaper_;
+
+    static constexpr __u64 wakeUpTag = 0;
+
+    void reaperLoop() {
+        std::vector<std::pair<std::unique_ptr<IoRequest>, ssize_t>> completed;
+        while (true) {
+            ring_.waitCompletion();
+            bool wokenUp = false;
+            bool stop = false;
+            {
+                // the lock also orders the reads of the requests after their creation by enqueue()
+                // (the kernel hands them over, which tools like ThreadSanitizer can not see)
+                std::lock_guard<std::mutex> lock(mtx_);
+                ring_.drainCompletions([&](const io_uring_cqe& cqe) {
+                    if (cqe.user_data == wakeUpTag) {
+                        wokenUp = true;
+                    } else {
+                        completed.emplace_back(reinterpret_cast<IoRequest*>(cqe.user_data), cqe.res);
+                    }
+                });
+                inFlight_ -= static_cast<unsigned>(completed.size());
+                reaping_ = !completed.empty();
+                stop = wokenUp && stopping_;
+            }
+            cv_.notify_all();
+
+            // the callbacks run without the lock, so they can queue new requests
+            for (auto& [request, result] : completed) {
+                if (request->done) {
+                    request->done(result);
+                }
+            }
+            completed.clear();
+            {
+                std::lock_guard<std::mutex> lock(mtx_);
+                submitOverflow();
+                reaping_ = false;
+            }
+            cv_.notify_all();
+            if (stop) {
+                return;
+            }
+        }
+    }
+
+    // mtx_ must be held: moves the requests the callbacks queued into the ring, as far as there is room
+    void submitOverflow() {
+        if (overflow_.empty()) {
+            return;
+        }
+        while (!overflow_.empty() && inFlight_ < ring_.entries()) {
+            prepare(takeSqe(), std::move(overflow_.front()));
+            overflow_.pop_front();
+        }
+        // submits them, and the unsubmitted requests of other threads that fill the ring: the rest of
+        // overflow_ waits for their completions
+        ring_.enter(0);
+    }
+
+    // mtx_ must be held, and inFlight_ < ring_.entries()
+    io_uring_sqe* takeSqe() {
+        // every sqe the ring hands out is counted in inFlight_ until its completion is drained
+        io_uring_sqe* sqe = ring_.getSqe();
+        assert(sqe);
+        ++inFlight_;
+        return sqe;
+    }
+
+    // mtx_ must be held
+    io_uring_sqe* nextSqe(std::unique_lock<std::mutex>& lock) {
+        if (inFlight_ >= ring_.entries()) {
+            ring_.enter(0); // some of them may not be submitted yet, they could never complete
+        }
+        cv_.wait(lock, [this] { return inFlight_ < ring_.entries(); });
+        return takeSqe();
+    }
+
+    static void prepare(io_uring_sqe* sqe, std::unique_ptr<IoRequest> owned) {
+        bool fixed = owned->bufIndex >= 0;
+        if (owned->op == IoRequest::Op::read) {
+            sqe->opcode = fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+        } else {
+            sqe->opcode = fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+        }
+        sqe->fd = owned->fd;
+        sqe->addr = reinterpret_cast<__u64>(owned->buf);
+        sqe->len = static_cast<__u32>(owned->len);
+        sqe->off = static_cast<__u64>(owned->offset);
+        if (fixed) {
+            sqe->buf_index = static_cast<__u16>(owned->bufIndex);
+        }
+        sqe->user_data = reinterpret_cast<__u64>(owned.release()); // owned by the completion from now on
+    }
+
+public:
+    explicit IoUringBackend(unsigned queueDepth) : ring_(queueDepth) {
+        reaper_ = std::thread(&IoUringBackend::reaperLoop, this);
+    }
+
+    ~IoUringBackend() override {
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            ring_.enter(0);
+            cv_.wait(lock, [this] { return inFlight_ == 0 && overflow_.empty() && !reaping_; });
+            stopping_ = true;
+            io_uring_sqe* sqe = nextSqe(lock);
+            sqe->opcode = IORING_OP_NOP;
+            sqe->user_data = wakeUpTag;
+            ring_.enter(0);
+        }
+        reaper_.join();
+    }
+
+    bool registerBuffers(const std::vector<std::span<std::byte>>& buffers) override {
+        std::vector<iovec> iovecs;
+        for (auto& b : buffers) {
+            iovecs.push_back({b.data(), b.size()});
+        }
+        std::lock_guard<std::mutex> lock(mtx_);
+        return ring_.registerBuffers(iovecs);
+    }
+
+    void enqueue(IoRequest request) override {
+        auto owned = std::make_unique<IoRequest>(std::move(request));
+        std::unique_lock<std::mutex> lock(mtx_);
+        if (std::this_thread::get_id() == reaper_.get_id()
+            && (inFlight_ >= ring_.entries() || !overflow_.empty())) {
+            overflow_.push_back(std::move(owned)); // a callback: waiting here would wait for itself
+            return;
+        }
+        prepare(nextSqe(lock), std::move(owned));
+    }
+
+    void submit() override {
+        std::lock_guard<std::mutex> lock(mtx_);
+        ring_.enter(0);
+    }
+};
+
+class ThreadPoolBackend : public IoBackend {
+private:
+    std::deque<IoRequest> queue_;   // submitted requests
+    std::vector<IoRequest> batch_;  // enqueued but not submitted yet
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+
+    void workerLoop() {
+        while (true) {
+            IoRequest request;
+            {
+                std::unique_lock<std::mutex> lock(mtx_);
+                cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+                if (queue_.empty()) {
+                    return; // stopping, and nothing left to do
+                }
+                request = std::move(queue_.front());
+                queue_.pop_front();
+            }
+            ssize_t ret;
+            do {
+                ret = request.op == IoRequest::Op::read
+                    ? ::pread(request.fd, request.buf, request.len, request.offset)
+                    : ::pwrite(request.fd, request.buf, request.len, request.offset);
+            } while (ret < 0 && errno == EINTR);
+            if (request.done) {
+                request.done(ret < 0 ? -errno : ret);
+            }
+        }
+    }
+
+public:
+    explicit ThreadPoolBackend(unsigned threads) {
+        for (unsigned i = 0; i < (threads > 0 ? threads : 1); ++i) {
+            workers_.emplace_back(&ThreadPoolBackend::workerLoop, this);
+        }
+    }
+
+    ~ThreadPoolBackend() override {
+        submit();
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        for (auto& w : workers_) {
+            w.join();
+        }
+    }
+
+    // nothing to register: pread/pwrite take any buffer
+    bool registerBuffers(const std::vector<std::span<std::byte>>&) override { return true; }
+
+    void enqueue(IoRequest request) override {
+        std::lock_guard<std::mutex> lock(mtx_);
+        batch_.push_back(std::move(request));
+    }
+
+    void submit() override {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            for (auto& r : batch_) {
+                queue_.push_back(std::move(r));
+            }
+            batch_.clear();
+        }
+        cv_.notify_all();
+    }
+};
+
+class AsyncFileEngine {
+public:
+    enum class Backend { automatic, ioUring, threadPool };
+    using Callback = std::function<void(ssize_t)>;
+
+private:
+    std::unique_ptr<IoBackend> backend_;
+    Backend kind_;
+    size_t batchSize_;
+    size_t queued_ = 0;
+    std::mutex queuedMtx_;
+
+    void add(IoRequest request) {
+        backend_->enqueue(std::move(request));
+        bool flush;
+        {
+            std::lock_guard<std::mutex> lock(queuedMtx_);
+            flush = ++queued_ >= batchSize_;
+            if (flush) {
+                queued_ = 0;
+            }
+        }
+        if (flush) {
+            backend_->submit();
+        }
+    }
+
+    template <typename Buf>
+    std::future<ssize_t> withFuture(IoRequest::Op op, int fd, Buf buf, size_t len, off_t offset, int bufIndex) {
+        auto promise = std::make_shared<std::promise<ssize_t>>();
+        std::future<ssize_t> f = promise->get_future();
+        add({op, fd, const_cast<void*>(static_cast<const void*>(buf)), len, offset, bufIndex,
+             [promise](ssize_t result) { promise->set_value(result); }});
+        return f;
+    }
+
+public:
+    // batchSize: the requests are submitted automatically every `batchSize` requests (1 = immediately),
+    // call submit() to flush a smaller batch.
+    explicit AsyncFileEngine(unsigned queueDepth = 256, Backend backend = Backend::automatic,
+                             size_t batchSize = 1, unsigned poolThreads = 4)
+        : kind_(backend), batchSize_(batchSize > 0 ? batchSize : 1) {
+        if (backend != Backend::threadPool) {
+            try {
+                backend_ = std::make_unique<IoUringBackend>(queueDepth);
+                kind_ = Backend::ioUring;
+            } catch (const std::system_error&) {
+                if (backend == Backend::ioUring) {
+                    throw; // explicitly requested
+                }
+            }
+        }
+        if (!backend_) {
+            backend_ = std::make_unique<ThreadPoolBackend>(poolThreads);
+            kind_ = Backend::threadPool;
+        }
+    }
+
+    // waits for every request still in flight
+    ~AsyncFileEngine() = default;
+
+    Backend backend() const { return kind_; }
+
+    // Registers buffers once (io_uring maps them in the kernel a single time); they are referenced by index
+    // in readFixed()/writeFixed(). Must be called before any I/O is queued.
+    bool registerBuffers(const std::vector<std::span<std::byte>>& buffers) {
+        return backend_->registerBuffers(buffers);
+    }
+
+    void read(int fd, void* buf, size_t len, off_t offset, Callback done) {
+        add({IoRequest::Op::read, fd, buf, len, offset, -1, std::move(done)});
+    }
+    void write(int fd, const void* buf, size_t len, off_t offset, Callback done) {
+        add({IoRequest::Op::write, fd, const_cast<void*>(buf), len, offset, -1, std::move(done)});
+    }
+    // `buf` must lie inside the registered buffer `bufIndex`
+    void readFixed(int fd, int bufIndex, void* buf, size_t len, off_t offset, Callback done) {
+        add({IoRequest::Op::read, fd, buf, len, offset, bufIndex, std::move(done)});
+    }
+    void writeFixed(int fd, int bufIndex, const void* buf, size_t len, off_t offset, Callback done) {
+        add({IoRequest::Op::write, fd, const_cast<void*>(buf), len, offset, bufIndex, std::move(done)});
+    }
+
+    std::future<ssize_t> read(int fd, void* buf, size_t len, off_t offset) {
+        return withFuture(IoRequest::Op::read, fd, buf, len, offset, -1);
+    }
+    std::future<ssize_t> write(int fd, const void* buf, size_t len, off_t offset) {
+        return withFuture(IoRequest::Op::write, fd, buf, len, offset, -1);
+    }
+
+    // submits the requests queued since the last submission
+    void submit() {
+        {
+            std::lock_guard<std::mutex> lock(queuedMtx_);
+            queued_ = 0;
+        }
+        backend_->submit();
+    }
+};
+
+#endif // ASYNC_FILE_IO_HPP
@@ -0,0 +1,189 @@
+#ifndef BUFFERED_WRITER_HPP
+#define BUFFERED_WRITER_HPP
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <initializer_list>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#include <sys/uio.h> // for writev
+#include <unistd.h>  // for fdatasync
+#include "uniqueFd.hpp"
+
+// Buffered writer for a file descriptor, with an explicit flush policy.
+// Writing one record with one write() (or std::endl, which flushes) costs one system call per record.
+// BufferedWriter collects the records in its own buffer and writes them out with writev():
+// * small records are copied into the buffer;
+// * a record that does not fit is not copied, it is written together with the buffer in one writev().
+//
+// Flush policies (when the buffered data is handed to the kernel):
+// * never:      only when the buffer is full, on flush() and in the destructor;
+// * onSize:     as soon as `flushBytes` are buffered;
+// * onInterval: on the first append after `flushInterval` since the last flush (there is no background thread);
+// * onSync:     every append is written and fdatasync'ed before it returns (slowest, every record is durable).
+//
+// Durability: a flush only gives the data to the page cache. With `syncEveryFlushes = N` the writer also calls
+// fdatasync() once every N flushes, so the cost of the disk flush is shared by all the records of the batch.
+// sync() forces flush + fdatasync at any time.
+//
+// Like std::ofstream, a BufferedWriter is not thread safe: protect it with a mutex (see LogFile) if needed.
+class BufferedWriter {
+public:
+    enum class FlushPolicy { never, onSize, onInterval, onSync };
+
+    struct Options {
+        size_t bufferSize = 64 * 1024;
+        FlushPolicy policy = FlushPolicy::onSize;
+        size_t flushBytes = 32 * 1024;                      // onSize
+        std::chrono::milliseconds flushInterval{100};       // onInterval
+        size_t syncEveryFlushes = 0;                        // 0: never call fdatasync automatically
+    };
+
+    struct Stats {
+        size_t writeCalls = 0; // writev system calls
+        size_t syncCalls = 0;  // fdatasync system calls
+        size_t bytes = 0;
+    };
+
+private:
+    UniqueFd fd_;
+    Options options_;
+    std::vector<char> buffer_;
+    size_t used_ = 0;
+    size_t flushesSinceSync_ = 0;
+    std::chrono::steady_clock::time_point lastFlush_ = std::chrono::steady_clock::now();
+    Stats stats_;
+
+    // writes every iovec, handling partial writes
+    void writeAll(iovec* iov, int count) {
+        while (count > 0) {
+            ssize_t n = ::writev(fd_.get(), iov, count);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::system_error(errno, std::generic_category(), "writev");
+            }
+            ++stats_.writeCalls;
+            stats_.bytes += static_cast<size_t>(n);
+            // skip what was written
+            auto written = static_cast<size_t>(n);
+            while (count > 0 && written >= iov->iov_len) {
+                written -= iov->iov_len;
+                ++iov;
+                --count;
+            }
+            if (count > 0) {
+                iov->iov_base = static_cast<char*>(iov->iov_base) + written;
+                iov->iov_len -= written;
+            }
+        }
+    }
+
+    // writes the buffer followed by `extra` (not copied), in one writev()
+    void flushWith(const iovec* extra, size_t extraCount) {
+        std::vector<iovec> iov;
+        iov.reserve(extraCount + 1);
+        if (used_ > 0) {
+            iov.push_back({buffer_.data(), used_});
+        }
+        for (size_t i = 0; i < extraCount; ++i) {
+            if (extra[i].iov_len > 0) {
+                iov.push_back(extra[i]);
+            }
+        }
+        if (iov.empty()) {
+            return; // nothing to write
+        }
+        writeAll(iov.data(), static_cast<int>(iov.size()));
+        used_ = 0;
+        lastFlush_ = std::chrono::steady_clock::now();
+        ++flushesSinceSync_;
+        if (options_.syncEveryFlushes > 0 && flushesSinceSync_ >= options_.syncEveryFlushes) {
+            datasync();
+        }
+    }
+
+    void datasync() {
+        if (::fdatasync(fd_.get()) == -1) {
+            throw std::system_error(errno, std::generic_category(), "fdatasync");
+        }
+        ++stats_.syncCalls;
+        flushesSinceSync_ = 0;
+    }
+
+    void applyPolicy() {
+        switch (options_.policy) {
+        case FlushPolicy::never:
+            break;
+        case FlushPolicy::onSize:
+            if (used_ >= options_.flushBytes) flush();
+            break;
+        case FlushPolicy::onInterval:
+            if (std::chrono::steady_clock::now() - lastFlush_ >= options_.flushInterval) flush();
+            break;
+        case FlushPolicy::onSync:
+            sync();
+            break;
+        }
+    }
+
+public:
+    explicit BufferedWriter(UniqueFd fd) : BufferedWriter(std::move(fd), Options{}) {}
+    BufferedWriter(UniqueFd fd, Options options)
+        : fd_(std::move(fd)), options_(options), buffer_(options.bufferSize > 0 ? options.bufferSize : 1) {}
+
+    // flushes what is left; errors can not be reported from a destructor, call flush() before to see them
+    ~BufferedWriter() {
+        try {
+            flush();
+        } catch (...) {
+        }
+    }
+
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+    // appends one record made of several pieces (e.g. a header, a payload and "\n")
+    void append(std::initializer_list<std::string_view> pieces) {
+        size_t total = 0;
+        for (std::string_view p : pieces) {
+            total += p.size();
+        }
+        if (used_ + total <= buffer_.size()) {
+            for (std::string_view p : pieces) {
+                std::memcpy(buffer_.data() + used_, p.data(), p.size());
+                used_ += p.size();
+            }
+        } else {
+            // gather write: the buffer and the pieces go out in one system call, without copying the pieces
+            std::vector<iovec> iov;
+            for (std::string_view p : pieces) {
+                iov.push_back({const_cast<char*>(p.data()), p.size()});
+            }
+            flushWith(iov.data(), iov.size());
+        }
+        applyPolicy();
+    }
+
+    void append(std::string_view record) { append({record}); }
+
+    // hands the buffered data to the kernel
+    void flush() { flushWith(nullptr, 0); }
+
+    // flush + fdatasync: the data is on the disk when sync() returns
+    void sync() {
+        flush();
+        if (flushesSinceSync_ > 0) {
+            datasync();
+        }
+    }
+
+    size_t buffered() const { return used_; }
+    const Stats& stats() const { return stats_; }
+    int fd() const { return fd_.get(); }
+};
+
+#endif // BUFFERED_WRITER_HPP
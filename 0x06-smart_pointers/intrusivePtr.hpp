@@ -0,0 +1,145 @@
+#ifndef INTRUSIVE_PTR_HPP
+#define INTRUSIVE_PTR_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+// Reference count policies.
+// `std::shared_ptr` always uses atomic increments/decrements, even if the object never leaves one thread.
+// With an intrusive pointer the counter lives inside the object, so we can choose the policy at compile time.
+struct NonAtomicRefCount {
+    long count = 0;
+
+    void increment() noexcept { ++count; }
+    // returns the new value of the counter
+    long decrement() noexcept { return --count; }
+    long load() const noexcept { return count; }
+};
+
+struct AtomicRefCount {
+    std::atomic<long> count{0};
+
+    // a new reference can only be created from an existing one, so no ordering is needed here
+    void increment() noexcept { count.fetch_add(1, std::memory_order_relaxed); }
+    // acq_rel: the thread that drops the last reference must see all the writes done through other references
+    long decrement() noexcept { return count.fetch_sub(1, std::memory_order_acq_rel) - 1; }
+    long load() const noexcept { return count.load(std::memory_order_relaxed); }
+};
+
+// Base class that embeds the counter in the object (CRTP: intrusive_release deletes through a Derived*, so no
+// virtual destructor is needed, as long as the object is not held as an IntrusivePtr to a class further up).
+// usage: struct Node : RefCounted<Node> { ... };              // single-threaded
+//        struct Node : RefCounted<Node, AtomicRefCount> { ... }; // shared across threads
+template <typename Derived, typename CountPolicy = NonAtomicRefCount>
+class RefCounted {
+private:
+    mutable CountPolicy refs_;
+
+protected:
+    RefCounted() = default;
+    ~RefCounted() = default;
+
+public:
+    // copying an object must not copy its reference count
+    RefCounted(const RefCounted&) noexcept {}
+    RefCounted& operator=(const RefCounted&) noexcept { return *this; }
+
+    long use_count() const noexcept { return refs_.load(); }
+
+    // found by argument dependent lookup from IntrusivePtr
+    friend void intrusive_add_ref(const Derived* p) noexcept {
+        p->refs_.increment();
+    }
+    friend void intrusive_release(const Derived* p) noexcept {
+        if (p->refs_.decrement() == 0) {
+            delete p;
+        }
+    }
+};
+
+template <typename T>
+class IntrusivePtr {
+private:
+    T* ptr_ = nullptr;
+
+    template <typename U> friend class IntrusivePtr;
+
+public:
+    using element_type = T;
+
+    IntrusivePtr() noexcept = default;
+    IntrusivePtr(std::nullptr_t) noexcept {}
+
+    // takes a new reference on `p`
+    explicit IntrusivePtr(T* p) noexcept : ptr_(p) {
+        if (ptr_) intrusive_add_ref(ptr_);
+    }
+
+    // copy constructor
+    IntrusivePtr(const IntrusivePtr& other) noexcept : ptr_(other.ptr_) {
+        if (ptr_) intrusive_add_ref(ptr_);
+    }
+    // move constructor (no counter traffic at all)
+    IntrusivePtr(IntrusivePtr&& other) noexcept : ptr_(std::exchange(other.ptr_, nullptr)) {}
+
+    // converting constructors (Derived -> Base): the last IntrusivePtr<Base> deletes through a Base*, which is
+    // only defined if Base has a virtual destructor
+    template <typename U>
+    static constexpr bool deletableAs =
+        std::is_same_v<std::remove_cv_t<U>, std::remove_cv_t<T>> || std::has_virtual_destructor_v<T>;
+
+    template <typename U>
+    IntrusivePtr(const IntrusivePtr<U>& other) noexcept : ptr_(other.ptr_) {
+        static_assert(deletableAs<U>, "IntrusivePtr<Base> from IntrusivePtr<Derived> needs a virtual ~Base()");
+        if (ptr_) intrusive_add_ref(ptr_);
+    }
+    template <typename U>
+    IntrusivePtr(IntrusivePtr<U>&& other) noexcept : ptr_(std::exchange(other.ptr_, nullptr)) {
+        static_assert(deletableAs<U>, "IntrusivePtr<Base> from IntrusivePtr<Derived> needs a virtual ~Base()");
+    }
+
+    ~IntrusivePtr() {
+        if (ptr_) intrusive_release(ptr_);
+    }
+
+    // copy and move assignment (copy-and-swap, handles self assignment)
+    IntrusivePtr& operator=(const IntrusivePtr& other) noexcept {
+        IntrusivePtr(other).swap(*this);
+        return *this;
+    }
+    IntrusivePtr& operator=(IntrusivePtr&& other) noexcept {
+        IntrusivePtr(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    void reset() noexcept { IntrusivePtr().swap(*this); }
+    void reset(T* p) noexcept { IntrusivePtr(p).swap(*this); }
+
+    void swap(IntrusivePtr& other) noexcept { std::swap(ptr_, other.ptr_); }
+
+    T* get() const noexcept { return ptr_; }
+    T& operator*() const noexcept { return *ptr_; }
+    T* operator->() const noexcept { return ptr_; }
+    explicit operator bool() const noexcept { return ptr_ != nullptr; }
+
+    long use_count() const noexcept { return ptr_ ? ptr_->use_count() : 0; }
+};
+
+template <typename T, typename U>
+bool operator==(const IntrusivePtr<T>& a, const IntrusivePtr<U>& b) noexcept {
+    return a.get() == b.get();
+}
+template <typename T>
+bool operator==(const IntrusivePtr<T>& a, std::nullptr_t) noexcept {
+    return a.get() == nullptr;
+}
+
+// Like std::make_shared, but there is no control block: one allocation holds the object and its counter.
+template <typename T, typename... Args>
+IntrusivePtr<T> make_intrusive(Args&&... args) {
+    return IntrusivePtr<T>(new T(std::forward<Args>(args)...));
+}
+
+#endif // INTRUSIVE_PTR_HPP
@@ -0,0 +1,95 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "uniqueFd.hpp"
+
+// Read-only memory mapping of a whole file.
+// Instead of copying the file through a small buffer with read(), the pages of the page cache are mapped
+// into our address space and the parser reads them directly (zero copy).
+class MappedFile {
+public:
+    // hints given to the kernel with madvise()
+    enum class Access {
+        normal,
+        sequential, // read ahead aggressively and drop pages behind us
+        random      // do not read ahead
+    };
+
+private:
+    void* addr_ = nullptr;
+    size_t size_ = 0;
+
+    void unmap() noexcept {
+        if (addr_) {
+            ::munmap(addr_, size_);
+            addr_ = nullptr;
+            size_ = 0;
+        }
+    }
+
+public:
+    MappedFile() noexcept = default;
+
+    // throws std::system_error if the file can not be opened or mapped
+    explicit MappedFile(const std::string& path, Access access = Access::sequential, bool willNeed = true) {
+        UniqueFd fd = UniqueFd::open(path, O_RDONLY);
+
+        struct stat st;
+        if (::fstat(fd.get(), &st) == -1) {
+            throw std::system_error(errno, std::generic_category(), "fstat " + path);
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ == 0) {
+            return; // mmap() does not accept an empty mapping, an empty file is an empty span
+        }
+
+        addr_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd.get(), 0);
+        if (addr_ == MAP_FAILED) {
+            addr_ = nullptr;
+            throw std::system_error(errno, std::generic_category(), "mmap " + path);
+        }
+        // the mapping stays valid after the descriptor is closed (by ~UniqueFd)
+
+        // the hints are only advice, a failure is not an error
+        if (access == Access::sequential) {
+            ::madvise(addr_, size_, MADV_SEQUENTIAL);
+        } else if (access == Access::random) {
+            ::madvise(addr_, size_, MADV_RANDOM);
+        }
+        if (willNeed) {
+            ::madvise(addr_, size_, MADV_WILLNEED); // start reading the file in the background
+        }
+    }
+
+    ~MappedFile() { unmap(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept
+        : addr_(std::exchange(other.addr_, nullptr)), size_(std::exchange(other.size_, 0)) {}
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            addr_ = std::exchange(other.addr_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+
+    std::span<const std::byte> bytes() const noexcept {
+        return {static_cast<const std::byte*>(addr_), size_};
+    }
+    size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+};
+
+#endif // MAPPED_FILE_HPP
@@ -0,0 +1,271 @@
+#ifndef POOL_ALLOCATOR_HPP
+#define POOL_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+// A pool of fixed size blocks, one pool per (block size, alignment).
+// Every thread keeps its own free list, so allocate/deallocate never take a lock and never call malloc
+// once the pool is warm. A block freed by another thread joins the freeing thread's list.
+// Behind the thread caches there is a depot, a list of batches of free blocks under a mutex:
+// * a thread that runs out of blocks takes a batch from the depot, and only carves a new chunk when it is empty;
+// * a thread whose list grows over `highWater` blocks (the consumer of a producer/consumer pair, which frees
+//   what the other one allocates) gives a batch back, so its list stays bounded;
+// * a thread that exits hands its whole list to the depot.
+//
+// The chunks are never given back to the system: a block can outlive the thread that carved it,
+// so the memory stays reserved until the program exits (this is the usual trade-off of object pools).
+template <size_t BlockSize, size_t BlockAlign>
+class FixedBlockPool {
+private:
+    struct FreeNode {
+        FreeNode* next;
+    };
+
+    // a block must be able to hold the free list link
+    static constexpr size_t blockAlign = BlockAlign < alignof(FreeNode) ? alignof(FreeNode) : BlockAlign;
+    static constexpr size_t blockSize = ((BlockSize < sizeof(FreeNode) ? sizeof(FreeNode) : BlockSize)
+                                         + blockAlign - 1) / blockAlign * blockAlign;
+    static constexpr size_t chunkBytes = 64 * 1024;
+    static constexpr size_t blocksPerChunk = chunkBytes / blockSize > 0 ? chunkBytes / blockSize : 1;
+
+    // blocks moved between a thread and the depot at once, and the most a thread keeps for itself
+    static constexpr size_t batchBlocks = blocksPerChunk;
+    static constexpr size_t highWater = 2 * batchBlocks;
+
+    struct Batch {
+        FreeNode* head;
+        FreeNode* tail;
+        size_t count;
+    };
+
+    // the free blocks no thread holds, and all the chunks ever allocated (only touched when a thread runs
+    // out of blocks, has too many, or exits)
+    struct Depot {
+        std::mutex mtx;
+        std::vector<Batch> batches;
+        size_t freeBlocks = 0;
+        std::vector<void*> chunks;
+
+        void put(Batch b) {
+            std::lock_guard<std::mutex> lock(mtx);
+            batches.push_back(b);
+            freeBlocks += b.count;
+        }
+    };
+    static Depot& depot() {
+        // intentionally leaked, see above: a thread can still exit after the static destructors have run
+        static Depot* d = new Depot();
+        return *d;
+    }
+
+    // trivially destructible, so the hot path reads it without the guard a thread_local with a destructor
+    // needs; the blocks are handed over at thread exit by ThreadExit, registered from the slow paths
+    struct ThreadCache {
+        FreeNode* head = nullptr;
+        size_t freeBlocks = 0;
+        size_t limit = 0;     // deallocate() takes the slow path above it: 0 until ThreadExit is registered
+        bool exited = false;  // after ThreadExit: freed blocks go straight to the depot
+    };
+
+    static ThreadCache& cache() {
+        thread_local ThreadCache c;
+        return c;
+    }
+
+    // the whole list goes to the depot
+    static void flush(ThreadCache& c) {
+        if (!c.head) {
+            return;
+        }
+        FreeNode* tail = c.head;
+        while (tail->next) {
+            tail = tail->next;
+        }
+        depot().put({c.head, tail, c.freeBlocks});
+        c.head = nullptr;
+        c.freeBlocks = 0;
+    }
+
+    // the blocks would be lost with the thread
+    struct ThreadExit {
+        ~ThreadExit() {
+            ThreadCache& c = cache();
+            flush(c);
+            c.exited = true;
+            c.limit = 0;
+        }
+    };
+
+    static void registerExit(ThreadCache& c) {
+        if (c.limit == 0 && !c.exited) {
+            thread_local ThreadExit hook; // constructed on the first call in each thread
+            c.limit = highWater;
+        }
+    }
+
+    static void refill(ThreadCache& c) {
+        registerExit(c);
+        Depot& d = depot();
+        {
+            std::lock_guard<std::mutex> lock(d.mtx);
+            if (!d.batches.empty()) {
+                Batch b = d.batches.back();
+                d.batches.pop_back();
+                d.freeBlocks -= b.count;
+                b.tail->next = c.head;
+                c.head = b.head;
+                c.freeBlocks += b.count;
+                return;
+            }
+        }
+        void* chunk = ::operator new(blocksPerChunk * blockSize, std::align_val_t(blockAlign));
+        {
+            std::lock_guard<std::mutex> lock(d.mtx);
+            d.chunks.push_back(chunk);
+        }
+        // thread the new blocks onto the free list
+        char* base = static_cast<char*>(chunk);
+        for (size_t i = blocksPerChunk; i-- > 0;) {
+            auto* node = reinterpret_cast<FreeNode*>(base + i * blockSize);
+            node->next = c.head;
+            c.head = node;
+        }
+        c.freeBlocks += blocksPerChunk;
+    }
+
+    // the first batchBlocks blocks of the list go to the depot
+    static void spill(ThreadCache& c) {
+        FreeNode* head = c.head;
+        FreeNode* tail = head;
+        for (size_t i = 1; i < batchBlocks; ++i) {
+            tail = tail->next;
+        }
+        c.head = tail->next;
+        c.freeBlocks -= batchBlocks;
+        tail->next = nullptr;
+        depot().put({head, tail, batchBlocks});
+    }
+
+    // deallocate() went over c.limit: the first free of a thread, a list over highWater, or a thread that exited
+    static void overflow(ThreadCache& c) {
+        registerExit(c);
+        if (c.exited) {
+            flush(c);
+        } else if (c.freeBlocks > highWater) {
+            spill(c);
+        }
+    }
+
+public:
+    static void* allocate() {
+        ThreadCache& c = cache();
+        if (!c.head) {
+            refill(c);
+        }
+        FreeNode* node = c.head;
+        c.head = node->next;
+        --c.freeBlocks;
+        return node;
+    }
+
+    static void deallocate(void* p) noexcept {
+        ThreadCache& c = cache();
+        auto* node = static_cast<FreeNode*>(p);
+        node->next = c.head;
+        c.head = node;
+        if (++c.freeBlocks > c.limit) {
+            overflow(c);
+        }
+    }
+
+    // statistics
+    static size_t threadFreeBlocks() { return cache().freeBlocks; }
+    static size_t depotFreeBlocks() {
+        std::lock_guard<std::mutex> lock(depot().mtx);
+        return depot().freeBlocks;
+    }
+    static size_t chunkCount() {
+        std::lock_guard<std::mutex> lock(depot().mtx);
+        return depot().chunks.size();
+    }
+    static constexpr size_t maxThreadFreeBlocks() { return highWater; }
+};
+
+// A standard allocator on top of FixedBlockPool.
+// std::allocate_shared rebinds it to its internal control block type, so the object and the control block
+// come from the pool of that block's size and alignment (shared with every other type of the same size and
+// alignment).
+template <typename T>
+class PoolAllocator {
+public:
+    using value_type = T;
+    using pool = FixedBlockPool<sizeof(T), alignof(T)>;
+
+    PoolAllocator() noexcept = default;
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        if (n == 1) {
+            return static_cast<T*>(pool::allocate());
+        }
+        // arrays are not pooled
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if (n == 1) {
+            pool::deallocate(p);
+        } else {
+            ::operator delete(p, std::align_val_t(alignof(T)));
+        }
+    }
+
+    // all pool allocators are interchangeable
+    template <typename U>
+    bool operator==(const PoolAllocator<U>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const PoolAllocator<U>&) const noexcept { return false; }
+};
+
+// Same as std::make_shared, but the single allocation (object + control block) comes from the pool.
+template <typename T, typename... Args>
+std::shared_ptr<T> make_pooled_shared(Args&&... args) {
+    return std::allocate_shared<T>(PoolAllocator<T>(), std::forward<Args>(args)...);
+}
+
+// `new`/`delete` replacements for a single pooled object, useful when a custom deleter is needed
+// (the deleter runs its own cleanup and then calls pool_delete instead of `delete`).
+template <typename T, typename... Args>
+T* pool_new(Args&&... args) {
+    PoolAllocator<T> alloc;
+    T* p = alloc.allocate(1);
+    try {
+        return ::new (static_cast<void*>(p)) T(std::forward<Args>(args)...);
+    } catch (...) {
+        alloc.deallocate(p, 1);
+        throw;
+    }
+}
+
+template <typename T>
+void pool_delete(T* p) noexcept {
+    if (p) {
+        p->~T();
+        PoolAllocator<T>().deallocate(p, 1);
+    }
+}
+
+// For the custom deleter form `std::shared_ptr<T>(p, deleter)`: the object is owned by the caller's
+// deleter, but the separate control block is taken from the pool instead of the global heap.
+template <typename T, typename Deleter>
+std::shared_ptr<T> pooled_shared_with_deleter(T* p, Deleter d) {
+    return std::shared_ptr<T>(p, std::move(d), PoolAllocator<T>());
+}
+
+#endif // POOL_ALLOCATOR_HPP
@@ -0,0 +1,175 @@
+// Hot reload of an immutable configuration with shared_ptr snapshots
+// A writer thread keeps publishing new versions of a routing table while reader threads keep reading it.
+// * with a mutex, every reader blocks while the writer swaps the pointer;
+// * with SnapshotCell, readers never block: they get the current version as a shared_ptr<const T>,
+//   and an old version is destroyed when the last reader that still uses it lets it go.
+// usage: ./a.out [number_of_readers] [milliseconds_per_run]
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <map>
+#include "snapshotCell.hpp"
+
+// Counts live versions, so we can check that old versions are reclaimed.
+std::atomic<long> liveTables{0};
+
+struct RoutingTable {
+    long version = 0;
+    std::map<int, int> routes;
+
+    RoutingTable() { liveTables++; }
+    RoutingTable(const RoutingTable& other) : version(other.version), routes(other.routes) { liveTables++; }
+    ~RoutingTable() { liveTables--; }
+};
+
+RoutingTable makeTable(long version) {
+    RoutingTable t;
+    t.version = version;
+    for (int i = 0; i < 16; ++i) {
+        t.routes[i] = static_cast<int>(version) + i;
+    }
+    return t;
+}
+
+// The classic way: a shared_ptr protected by a mutex.
+class MutexCell {
+private:
+    mutable std::mutex mtx;
+    std::shared_ptr<const RoutingTable> current;
+public:
+    explicit MutexCell(RoutingTable t) : current(std::make_shared<const RoutingTable>(std::move(t))) {}
+    std::shared_ptr<const RoutingTable> load() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        return current;
+    }
+    void store(RoutingTable t) {
+        auto next = std::make_shared<const RoutingTable>(std::move(t));
+        std::lock_guard<std::mutex> lock(mtx);
+        current.swap(next);
+    } // the old version (if unused) is destroyed outside the lock
+};
+
+// The C++20 way: std::atomic<std::shared_ptr> (not lock-free in libstdc++).
+class StdAtomicCell {
+private:
+    std::atomic<std::shared_ptr<const RoutingTable>> current;
+public:
+    explicit StdAtomicCell(RoutingTable t) : current(std::make_shared<const RoutingTable>(std::move(t))) {}
+    std::shared_ptr<const RoutingTable> load() const { return current.load(); }
+    void store(RoutingTable t) { current.store(std::make_shared<const RoutingTable>(std::move(t))); }
+};
+
+template <typename Cell>
+void runBenchmark(const std::string& name, int readers, std::chrono::milliseconds duration) {
+    Cell cell(makeTable(0));
+    std::atomic<bool> stop{false};
+    std::atomic<long> reads{0};
+    long published = 0;
+
+    std::vector<std::thread> threads;
+    for (int r = 0; r < readers; ++r) {
+        threads.emplace_back([&] {
+            long local = 0;
+            long lastVersion = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                std::shared_ptr<const RoutingTable> table = cell.load();
+                // versions are published in order, a reader can never go back in time
+                if (table->version < lastVersion) {
+                    std::cerr << "version went backwards!\n";
+                }
+                lastVersion = table->version;
+                local++;
+            }
+            reads += local;
+        });
+    }
+
+    // the writer publishes new versions as fast as it can
+    auto end = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < end) {
+        cell.store(makeTable(++published));
+    }
+    stop = true;
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    double seconds = std::chrono::duration<double>(duration).count();
+    std::cout << name << ": " << reads.load() / seconds / 1e6 << " M reads/s, "
+              << published / seconds / 1e3 << " K publishes/s\n";
+}
+
+// Checks that every old version is destroyed once no reader holds it anymore.
+bool reclamationTest() {
+    bool ok = true;
+    {
+        SnapshotCell<RoutingTable> cell(makeTable(0));
+
+        std::shared_ptr<const RoutingTable> pinned = cell.load(); // a slow reader keeps version 0 alive
+        for (long v = 1; v <= 1000; ++v) {
+            cell.store(makeTable(v));
+        }
+        // only version 0 (pinned) and version 1000 (current) are alive
+        if (liveTables.load() != 2) {
+            std::cout << "expected 2 live versions, got " << liveTables.load() << "\n";
+            ok = false;
+        }
+        pinned.reset();
+        if (liveTables.load() != 1) {
+            std::cout << "expected 1 live version, got " << liveTables.load() << "\n";
+            ok = false;
+        }
+
+        // same thing with concurrent readers and writers
+        std::atomic<bool> stop{false};
+        std::vector<std::thread> readers;
+        for (int r = 0; r < 4; ++r) {
+            readers.emplace_back([&] {
+                while (!stop) {
+                    auto t = cell.load();
+                    (void)t->routes.size();
+                }
+            });
+        }
+        for (long v = 1001; v <= 100000; ++v) {
+            cell.store(makeTable(v));
+        }
+        stop = true;
+        for (auto& t : readers) {
+            t.join();
+        }
+        if (liveTables.load() != 1 || cell.load()->version != 100000) {
+            std::cout << "expected only the last version to be alive, got " << liveTables.load() << "\n";
+            ok = false;
+        }
+    }
+    // the cell is gone, so is the last version
+    if (liveTables.load() != 0) {
+        std::cout << "leaked " << liveTables.load() << " versions\n";
+        ok = false;
+    }
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    int readers = argc > 1 ? std::stoi(argv[1]) : 4;
+    std::chrono::milliseconds duration(argc > 2 ? std::stoi(argv[2]) : 1000);
+
+    bool ok = reclamationTest();
+    std::cout << "reclamation test: " << (ok ? "passed" : "FAILED") << "\n";
+
+    std::cout << "SnapshotCell is lock-free: " << std::boolalpha << SnapshotCell<RoutingTable>::isLockFree
+              << " (std::atomic<std::shared_ptr> is lock-free: "
+              << std::atomic<std::shared_ptr<const RoutingTable>>::is_always_lock_free << ")\n";
+
+    runBenchmark<MutexCell>("mutex + shared_ptr          ", readers, duration);
+    runBenchmark<StdAtomicCell>("std::atomic<shared_ptr>     ", readers, duration);
+    runBenchmark<SnapshotCell<RoutingTable>>("SnapshotCell                ", readers, duration);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,80 @@
+// weak_ptr based cache
+// 0x03-circular_ref.cpp uses weak_ptr to break a cycle; here weak_ptr is used to observe objects without owning them.
+// Several worker threads need the same large assets. Without a cache every thread loads its own copy;
+// with WeakCache an asset is loaded once and shared for as long as somebody holds it.
+// usage: ./a.out [number_of_threads] [number_of_assets]
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include "weakCache.hpp"
+
+std::atomic<int> loads{0};
+
+struct Asset {
+    std::string name;
+    std::vector<char> data;
+    explicit Asset(std::string n) : name(std::move(n)), data(1 << 20) { // 1 MB
+        loads++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20)); // simulating a slow load from disk
+    }
+};
+
+// every worker uses every asset for a while
+template <typename GetFn>
+void worker(int assets, GetFn get) {
+    std::vector<std::shared_ptr<Asset>> inUse;
+    for (int i = 0; i < assets; ++i) {
+        inUse.push_back(get("asset_" + std::to_string(i)));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+} // the worker drops its assets here
+
+template <typename GetFn>
+void run(const std::string& name, int threads, int assets, GetFn get) {
+    loads = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] { worker(assets, get); });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name << ": " << loads << " loads, " << ms << " ms\n";
+}
+
+int main(int argc, char* argv[]) {
+    int threads = argc > 1 ? std::stoi(argv[1]) : 8;
+    int assets = argc > 2 ? std::stoi(argv[2]) : 10;
+
+    run("no cache  ", threads, assets, [](const std::string& key) {
+        return std::make_shared<Asset>(key);
+    });
+
+    WeakCache<std::string, Asset> cache;
+    auto cached = [&cache](const std::string& key) {
+        return cache.get(key, [&key] { return std::make_shared<Asset>(key); });
+    };
+    run("WeakCache ", threads, assets, cached);
+
+    // the cache does not keep anything alive: all the workers are done, so all the entries are expired
+    std::cout << "alive after the workers finished: " << (cache.find("asset_0") ? "yes" : "no") << "\n";
+
+    // expired entries are removed a few buckets at a time by the next insertions
+    std::cout << "entries before new insertions: " << cache.size() << "\n";
+    {
+        std::vector<std::shared_ptr<Asset>> keep;
+        for (int i = 0; i < 2 * assets; ++i) {
+            keep.push_back(cached("other_" + std::to_string(i)));
+        }
+        std::cout << "entries after " << 2 * assets << " insertions: " << cache.size()
+                  << " (" << 2 * assets << " alive)\n";
+    }
+    std::cout << "purgeExpired() removed " << cache.purgeExpired() << " entries\n";
+    return 0;
+}
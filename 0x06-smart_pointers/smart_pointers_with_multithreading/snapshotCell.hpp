@@ -0,0 +1,161 @@
+#ifndef SNAPSHOT_CELL_HPP
+#define SNAPSHOT_CELL_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+// SnapshotCell<T> holds the current version of an immutable object (a configuration, a routing table, ...).
+// * Readers call load() and get a std::shared_ptr<const T>; they never take a lock, so a writer
+//   publishing a new version can not block them. With the split reference count below, load() is also
+//   wait-free; std::atomic<std::shared_ptr<T>>, when it is lock-free, only promises lock-free.
+// * Writers call store() (or update()) to publish a new version. The old version is destroyed as soon as
+//   the last reader that loaded it drops its shared_ptr.
+//
+// The natural implementation is std::atomic<std::shared_ptr<T>> (C++20), but it is allowed to use a lock
+// internally (libstdc++ does). When it is not lock-free we use a split reference count instead.
+
+// Split reference count:
+// the current node and an "acquired" count are packed in one 64-bit word, and every node counts its releases.
+// * a reader increments the acquired count and reads the pointer in one atomic fetch_add, so the node can
+//   not be freed while the reader copies the shared_ptr out of it;
+// * then it increments the node's released count, one more fetch_add: load() has no retry loop, it is
+//   wait-free (two atomic read-modify-writes, whatever the writers do);
+// * a writer that replaces a node adds the "retired" flag and the number of acquisitions to the released
+//   count, and whoever makes released == acquired on a retired node (the writer, or the last reader) deletes it.
+// The acquired count only has 16 bits and wraps around, so the two counts are compared modulo 2^16: that is
+// exact as long as fewer than 65536 readers are inside load() at the same time.
+template <typename T>
+class SplitRefCountSnapshot {
+private:
+    // user space pointers fit in the low 48 bits on x86-64 and AArch64, the high 16 bits count acquisitions
+    static_assert(sizeof(void*) == 8, "the split reference count needs 64-bit pointers");
+    static constexpr int countShift = 48;
+    static constexpr uint64_t countOne = uint64_t(1) << countShift;
+    static constexpr uint64_t pointerMask = countOne - 1;
+    static constexpr uint64_t countModulo = uint64_t(1) << (64 - countShift);
+
+    struct Node {
+        std::shared_ptr<const T> value;
+        // low bits: releases (+ countModulo - acquisitions once retired), top bit: retired
+        std::atomic<uint64_t> released{0};
+        explicit Node(std::shared_ptr<const T> v) : value(std::move(v)) {}
+    };
+    static constexpr uint64_t retiredFlag = uint64_t(1) << 63;
+
+    // released == acquired (mod 2^16) on a retired node: nobody uses it anymore
+    static bool unused(uint64_t released) {
+        return (released & retiredFlag) && (released & (countModulo - 1)) == 0;
+    }
+
+    static Node* nodeOf(uint64_t word) { return reinterpret_cast<Node*>(word & pointerMask); }
+    static uint64_t countOf(uint64_t word) { return word >> countShift; }
+    static uint64_t pack(Node* n) { return reinterpret_cast<uint64_t>(n); }
+
+    mutable std::atomic<uint64_t> word_{0};
+
+    // called by a reader that acquired `node`
+    static void releaseReader(Node* node) {
+        // acq_rel: our copy of the value happens before the delete, wherever it runs
+        if (node && unused(node->released.fetch_add(1, std::memory_order_acq_rel) + 1)) {
+            delete node;
+        }
+    }
+
+    // called by a writer after it replaced the packed word `old`
+    static void retire(uint64_t old) {
+        Node* node = nodeOf(old);
+        if (!node) {
+            return;
+        }
+        // + countModulo - acquired: the low bits reach 0 (mod 2^16) when released == acquired, without a borrow
+        uint64_t add = retiredFlag + countModulo - countOf(old);
+        if (unused(node->released.fetch_add(add, std::memory_order_acq_rel) + add)) {
+            delete node; // no reader is still using it
+        }
+    }
+
+public:
+    static constexpr bool isLockFree = true;
+
+    SplitRefCountSnapshot() = default;
+    explicit SplitRefCountSnapshot(std::shared_ptr<const T> initial) { store(std::move(initial)); }
+    ~SplitRefCountSnapshot() { retire(word_.load(std::memory_order_acquire)); }
+
+    SplitRefCountSnapshot(const SplitRefCountSnapshot&) = delete;
+    SplitRefCountSnapshot& operator=(const SplitRefCountSnapshot&) = delete;
+
+    // wait-free
+    std::shared_ptr<const T> load() const {
+        // the count carries out of bit 63 when it wraps around, the pointer bits are never touched
+        uint64_t cur = word_.fetch_add(countOne, std::memory_order_acquire);
+        Node* node = nodeOf(cur);
+        std::shared_ptr<const T> result;
+        if (node) {
+            result = node->value; // safe: the node is not retired, or counts us among its acquisitions
+        }
+        releaseReader(node);
+        return result;
+    }
+
+    void store(std::shared_ptr<const T> value) {
+        Node* node = new Node(std::move(value));
+        retire(word_.exchange(pack(node), std::memory_order_acq_rel));
+    }
+};
+
+// Backend used when std::atomic<std::shared_ptr<T>> is lock-free.
+template <typename T>
+class AtomicSharedPtrSnapshot {
+private:
+    std::atomic<std::shared_ptr<const T>> ptr_;
+
+public:
+    static constexpr bool isLockFree = std::atomic<std::shared_ptr<const T>>::is_always_lock_free;
+
+    AtomicSharedPtrSnapshot() = default;
+    explicit AtomicSharedPtrSnapshot(std::shared_ptr<const T> initial) : ptr_(std::move(initial)) {}
+
+    std::shared_ptr<const T> load() const { return ptr_.load(std::memory_order_acquire); }
+    void store(std::shared_ptr<const T> value) { ptr_.store(std::move(value), std::memory_order_release); }
+};
+
+template <typename T>
+using SnapshotBackend = std::conditional_t<AtomicSharedPtrSnapshot<T>::isLockFree,
+                                           AtomicSharedPtrSnapshot<T>,
+                                           SplitRefCountSnapshot<T>>;
+
+template <typename T>
+class SnapshotCell {
+private:
+    SnapshotBackend<T> current_;
+    std::mutex writer_mtx_; // only serializes update(), readers never touch it
+
+public:
+    SnapshotCell() = default;
+    explicit SnapshotCell(std::shared_ptr<const T> initial) : current_(std::move(initial)) {}
+    explicit SnapshotCell(T initial) : current_(std::make_shared<const T>(std::move(initial))) {}
+
+    static constexpr bool isLockFree = SnapshotBackend<T>::isLockFree;
+
+    // the returned version stays valid (and unchanged) for as long as the caller holds it
+    std::shared_ptr<const T> load() const { return current_.load(); }
+
+    // publishes a new version
+    void store(std::shared_ptr<const T> value) { current_.store(std::move(value)); }
+    void store(T value) { store(std::make_shared<const T>(std::move(value))); }
+
+    // read-copy-update: builds the next version from the current one.
+    // Concurrent update() calls are serialized so that no update is lost.
+    template <typename Fn>
+    void update(Fn fn) {
+        std::lock_guard<std::mutex> lock(writer_mtx_);
+        std::shared_ptr<const T> old = current_.load();
+        store(std::make_shared<const T>(fn(*old)));
+    }
+};
+
+#endif // SNAPSHOT_CELL_HPP
@@ -0,0 +1,160 @@
+#ifndef WEAK_CACHE_HPP
+#define WEAK_CACHE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// WeakCache<K, V> deduplicates expensive objects between threads without keeping them alive:
+// * the cache hands out std::shared_ptr<V>, but keeps only a std::weak_ptr<V> for itself,
+//   so an object lives exactly as long as somebody outside the cache uses it;
+// * while an object is alive, every get() for its key returns the same object;
+// * if several threads ask for a missing key at the same time, only one of them runs the factory,
+//   the others wait for its result;
+// * expired entries are removed lazily: every insertion also checks a few buckets of the map
+//   (a moving cursor), so the cleanup cost is spread over the insertions instead of a full scan per lookup.
+//
+// The map is split in shards, each with its own mutex, to reduce contention between threads.
+template <typename K, typename V, typename Hash = std::hash<K>>
+class WeakCache {
+private:
+    struct Entry {
+        std::weak_ptr<V> value;
+        // valid while a thread is running the factory for this key
+        std::shared_future<std::shared_ptr<V>> pending;
+    };
+
+    struct Shard {
+        std::mutex mtx;
+        std::unordered_map<K, Entry, Hash> map;
+        size_t cursor = 0; // next bucket to check for expired entries
+    };
+
+    std::vector<Shard> shards_;
+    size_t purgeBuckets_;
+    Hash hash_;
+
+    Shard& shardFor(const K& key) {
+        // mix the hash a bit, std::hash of integers is often the identity
+        size_t h = hash_(key) * 0x9E3779B97F4A7C15ull;
+        return shards_[(h >> 32) % shards_.size()];
+    }
+
+    // removes the expired entries of `purgeBuckets_` buckets (the shard mutex must be held)
+    size_t purgeSome(Shard& shard) {
+        size_t removed = 0;
+        size_t buckets = shard.map.bucket_count();
+        for (size_t i = 0; i < purgeBuckets_; ++i) {
+            size_t b = shard.cursor++ % buckets;
+            // collect first: erasing invalidates the local iterators of the bucket
+            std::vector<K> expired;
+            for (auto it = shard.map.begin(b); it != shard.map.end(b); ++it) {
+                if (it->second.value.expired() && !it->second.pending.valid()) {
+                    expired.push_back(it->first);
+                }
+            }
+            for (const K& k : expired) {
+                shard.map.erase(k);
+                ++removed;
+            }
+        }
+        return removed;
+    }
+
+public:
+    explicit WeakCache(size_t shardCount = 16, size_t purgeBucketsPerInsert = 2)
+        : shards_(shardCount > 0 ? shardCount : 1), purgeBuckets_(purgeBucketsPerInsert) {}
+
+    WeakCache(const WeakCache&) = delete;
+    WeakCache& operator=(const WeakCache&) = delete;
+
+    // Returns the live object for `key`, or creates it with `factory()` (a callable returning std::shared_ptr<V>).
+    // The factory runs outside the lock. If it throws, the exception is thrown to every waiting caller.
+    template <typename Factory>
+    std::shared_ptr<V> get(const K& key, Factory&& factory) {
+        Shard& shard = shardFor(key);
+        std::promise<std::shared_ptr<V>> promise;
+        {
+            std::unique_lock<std::mutex> lock(shard.mtx);
+            auto it = shard.map.find(key);
+            if (it != shard.map.end()) {
+                if (std::shared_ptr<V> alive = it->second.value.lock()) {
+                    return alive; // cache hit
+                }
+                if (it->second.pending.valid()) {
+                    // another thread is creating it right now, wait for it outside the lock
+                    std::shared_future<std::shared_ptr<V>> pending = it->second.pending;
+                    lock.unlock();
+                    return pending.get();
+                }
+            } else {
+                purgeSome(shard);
+                it = shard.map.emplace(key, Entry{}).first;
+            }
+            // we are the thread that creates the object
+            it->second.pending = promise.get_future().share();
+        }
+
+        std::shared_ptr<V> created;
+        try {
+            created = factory();
+        } catch (...) {
+            {
+                std::lock_guard<std::mutex> lock(shard.mtx);
+                shard.map.erase(key);
+            }
+            promise.set_exception(std::current_exception());
+            throw;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(shard.mtx);
+            Entry& entry = shard.map[key];
+            entry.value = created;
+            entry.pending = {}; // waiters keep their own copy of the future
+        }
+        promise.set_value(created);
+        return created;
+    }
+
+    // Returns the live object for `key`, or nullptr.
+    std::shared_ptr<V> find(const K& key) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        auto it = shard.map.find(key);
+        return it != shard.map.end() ? it->second.value.lock() : nullptr;
+    }
+
+    // Number of entries, including the expired ones that were not purged yet.
+    size_t size() {
+        size_t total = 0;
+        for (Shard& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mtx);
+            total += shard.map.size();
+        }
+        return total;
+    }
+
+    // Full scan, for when the caller knows that many objects just died (e.g. at the end of a level).
+    size_t purgeExpired() {
+        size_t removed = 0;
+        for (Shard& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mtx);
+            for (auto it = shard.map.begin(); it != shard.map.end();) {
+                if (it->second.value.expired() && !it->second.pending.valid()) {
+                    it = shard.map.erase(it);
+                    ++removed;
+                } else {
+                    ++it;
+                }
+            }
+        }
+        return removed;
+    }
+};
+
+#endif // WEAK_CACHE_HPP
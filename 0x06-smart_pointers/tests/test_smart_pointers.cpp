@@ -0,0 +1,215 @@
+// Tests for the headers of this module: the thread caches and the depot of FixedBlockPool (poolAllocator.hpp)
+// the split reference count of SnapshotCell (snapshotCell.hpp) and the completion thread of AsyncFileEngine
+// (asyncFileIo.hpp).
+// Every check is an assert: the test target is compiled without NDEBUG, whatever the build type.
+// usage: ./a.out
+#include <cassert>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "../asyncFileIo.hpp"
+#include "../poolAllocator.hpp"
+#include "../smart_pointers_with_multithreading/snapshotCell.hpp"
+
+// one pool per test: the block sizes are not used anywhere else in the program
+using ExitPool = FixedBlockPool<200, 8>;
+using HandOffPool = FixedBlockPool<216, 8>;
+
+// a thread that exits gives its free blocks to the depot, and the next thread takes them from there
+void testThreadExitReturnsBlocks() {
+    const size_t n = 5000;
+    auto churn = [n] {
+        std::vector<void*> blocks;
+        for (size_t i = 0; i < n; ++i) {
+            blocks.push_back(ExitPool::allocate());
+        }
+        for (void* p : blocks) {
+            ExitPool::deallocate(p);
+        }
+        assert(ExitPool::threadFreeBlocks() <= ExitPool::maxThreadFreeBlocks());
+    };
+    std::thread(churn).join();
+    size_t chunks = ExitPool::chunkCount();
+    assert(chunks > 0);
+    assert(ExitPool::depotFreeBlocks() >= n);
+    for (int round = 0; round < 5; ++round) {
+        std::thread(churn).join();
+    }
+    assert(ExitPool::chunkCount() == chunks);
+}
+
+// producer/consumer: every block is allocated by one thread and freed by another. The consumer's list stays
+// under the high-water mark, and the producer of the next round reuses the blocks instead of new chunks.
+void testHandOffIsBounded() {
+    const size_t n = 20000;
+    size_t chunks = 0;
+    for (int round = 0; round < 5; ++round) {
+        std::vector<void*> blocks;
+        std::thread producer([&] {
+            for (size_t i = 0; i < n; ++i) {
+                blocks.push_back(HandOffPool::allocate());
+            }
+        });
+        producer.join();
+        std::thread consumer([&] {
+            for (void* p : blocks) {
+                HandOffPool::deallocate(p);
+                assert(HandOffPool::threadFreeBlocks() <= HandOffPool::maxThreadFreeBlocks());
+            }
+        });
+        consumer.join();
+        if (round == 0) {
+            chunks = HandOffPool::chunkCount();
+        }
+        assert(HandOffPool::chunkCount() == chunks);
+        assert(HandOffPool::depotFreeBlocks() >= n);
+    }
+}
+
+struct Node {
+    long value;
+    explicit Node(long v) : value(v) {}
+};
+
+void testPooledSharedPtr() {
+    std::vector<std::shared_ptr<Node>> nodes;
+    for (long i = 0; i < 10000; ++i) {
+        nodes.push_back(make_pooled_shared<Node>(i));
+    }
+    for (long i = 0; i < 10000; ++i) {
+        assert(nodes[i]->value == i && nodes[i].use_count() == 1);
+    }
+    nodes.clear();
+
+    Node* raw = pool_new<Node>(7);
+    bool deleted = false;
+    {
+        std::shared_ptr<Node> sp = pooled_shared_with_deleter(raw, [&deleted](Node* p) {
+            deleted = true;
+            pool_delete(p);
+        });
+        assert(sp->value == 7);
+    }
+    assert(deleted);
+}
+
+// counts the live versions, to check that every replaced version is destroyed once, and not too early
+struct Version {
+    static inline std::atomic<long> alive{0};
+    long number;
+    explicit Version(long n) : number(n) { ++alive; }
+    ~Version() { --alive; }
+};
+
+void testSplitRefCountSnapshot() {
+    {
+        SplitRefCountSnapshot<Version> cell(std::make_shared<const Version>(0));
+        // more loads than the 16-bit acquisition count holds: it wraps around, the version must survive
+        for (int i = 0; i < 200000; ++i) {
+            assert(cell.load()->number == 0);
+        }
+        std::shared_ptr<const Version> held = cell.load();
+        cell.store(std::make_shared<const Version>(1));
+        assert(Version::alive == 2 && held->number == 0); // still held by a reader
+        held.reset();
+        assert(Version::alive == 1);
+
+        // readers and a writer at the same time
+        std::atomic<bool> stop{false};
+        std::vector<std::thread> readers;
+        for (int r = 0; r < 3; ++r) {
+            readers.emplace_back([&] {
+                long last = 0;
+                while (!stop.load(std::memory_order_relaxed)) {
+                    long n = cell.load()->number;
+                    assert(n >= last); // versions only move forward
+                    last = n;
+                }
+            });
+        }
+        for (long v = 2; v < 2000; ++v) {
+            cell.store(std::make_shared<const Version>(v));
+        }
+        stop = true;
+        for (auto& r : readers) {
+            r.join();
+        }
+        assert(cell.load()->number == 1999 && Version::alive == 1);
+    }
+    assert(Version::alive == 0);
+}
+
+// A completion callback that queues new requests while the ring is full: every completion queues two more
+// reads, so the callbacks soon ask for more slots than a ring of 4 has. The completion thread must not wait
+// for a slot only it can free (that used to deadlock); the thread-pool backend runs the same chain.
+void testCallbackRequeuesOnFullRing(AsyncFileEngine::Backend backend) {
+    char path[] = "/tmp/test_smart_pointers_XXXXXX";
+    UniqueFd fd(::mkstemp(path));
+    assert(fd);
+    ::unlink(path);
+    const size_t blockSize = 4096;
+    std::vector<char> data(16 * blockSize, 'x');
+    assert(::pwrite(fd.get(), data.data(), data.size(), 0) == static_cast<ssize_t>(data.size()));
+
+    std::unique_ptr<AsyncFileEngine> engine;
+    try {
+        engine = std::make_unique<AsyncFileEngine>(4, backend, 1, 2);
+    } catch (const std::system_error& e) {
+        std::cout << "io_uring not available (" << e.what() << "), skipped" << std::endl;
+        return;
+    }
+
+    const int total = 400;
+    std::vector<std::vector<char>> buffers(total, std::vector<char>(blockSize));
+    std::atomic<int> issued{0};
+    std::mutex mtx;
+    std::condition_variable cv;
+    int completed = 0;
+    std::function<void()> readOne;
+    std::function<void(ssize_t)> onDone = [&](ssize_t result) {
+        assert(result == static_cast<ssize_t>(blockSize));
+        readOne(); // two more for every completion, while the other callbacks of the batch still hold slots
+        readOne();
+        std::lock_guard<std::mutex> lock(mtx);
+        if (++completed == total) {
+            cv.notify_all();
+        }
+    };
+    readOne = [&] {
+        int id = issued.fetch_add(1);
+        if (id < total) {
+            engine->read(fd.get(), buffers[id].data(), blockSize, (id % 16) * blockSize, onDone);
+        }
+    };
+    readOne(); // the callbacks issue all the others, so this thread never waits for a slot itself
+    std::unique_lock<std::mutex> lock(mtx);
+    if (!cv.wait_for(lock, std::chrono::seconds(20), [&] { return completed == total; })) {
+        std::cerr << "deadlock: " << completed << " of " << total << " reads completed" << std::endl;
+        std::_Exit(1); // the engine's destructor would wait forever
+    }
+    lock.unlock();
+    engine.reset();
+    for (const auto& b : buffers) {
+        assert(b[0] == 'x' && b[blockSize - 1] == 'x');
+    }
+}
+
+int main() {
+    testThreadExitReturnsBlocks();
+    testHandOffIsBounded();
+    testPooledSharedPtr();
+    testSplitRefCountSnapshot();
+    testCallbackRequeuesOnFullRing(AsyncFileEngine::Backend::ioUring);
+    testCallbackRequeuesOnFullRing(AsyncFileEngine::Backend::threadPool);
+    std::cout << "test_smart_pointers: all tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,62 @@
+#ifndef UNIQUE_FD_HPP
+#define UNIQUE_FD_HPP
+
+#include <cerrno>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <fcntl.h>  // for open flags
+#include <unistd.h> // for close
+
+// RAII owner of a POSIX file descriptor.
+// 0x05-custom_deleters.cpp uses `std::unique_ptr<int, decltype(&customFileDeleter_fd)>` pointing to a local int;
+// a descriptor is already a handle, so we store it by value and close it in the destructor (like unique_ptr, move-only).
+class UniqueFd {
+private:
+    int fd_ = -1;
+
+public:
+    UniqueFd() noexcept = default;
+    explicit UniqueFd(int fd) noexcept : fd_(fd) {}
+    ~UniqueFd() { reset(); }
+
+    UniqueFd(const UniqueFd&) = delete;
+    UniqueFd& operator=(const UniqueFd&) = delete;
+
+    UniqueFd(UniqueFd&& other) noexcept : fd_(std::exchange(other.fd_, -1)) {}
+    UniqueFd& operator=(UniqueFd&& other) noexcept {
+        if (this != &other) {
+            reset(std::exchange(other.fd_, -1));
+        }
+        return *this;
+    }
+
+    // opens `path`, throws std::system_error on failure
+    static UniqueFd open(const std::string& path, int flags, mode_t mode = 0644) {
+        int fd;
+        do {
+            fd = ::open(path.c_str(), flags | O_CLOEXEC, mode);
+        } while (fd == -1 && errno == EINTR);
+        if (fd == -1) {
+            throw std::system_error(errno, std::generic_category(), "open " + path);
+        }
+        return UniqueFd(fd);
+    }
+
+    int get() const noexcept { return fd_; }
+    bool valid() const noexcept { return fd_ != -1; }
+    explicit operator bool() const noexcept { return valid(); }
+
+    // gives up the ownership without closing
+    int release() noexcept { return std::exchange(fd_, -1); }
+
+    // closes the current descriptor (if any) and takes ownership of `fd`
+    void reset(int fd = -1) noexcept {
+        if (fd_ != -1) {
+            ::close(fd_); // the descriptor is released even if close() reports an error
+        }
+        fd_ = fd;
+    }
+};
+
+#endif // UNIQUE_FD_HPP
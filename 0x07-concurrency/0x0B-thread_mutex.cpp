@@ -2,6 +2,7 @@
 #include <thread>
 #include <mutex>
 #include <fstream>
+#include "logFile.hpp"
 
 /**
  * In the example:
@@ -30,28 +31,7 @@
 //     // use the more enhanced version below.
 // }
 
-// More enhanced version
-class LogFile {
-public:
-    LogFile() {
-        file.open("log.txt");
-    }
-
-    ~LogFile() {
-        file.close();
-    }
-
-    void shared_print(const std::string& message, const int& num) {
-        std::lock_guard<std::mutex> guard(mtx);
-        // the file will only accessed shared_print function.
-        // "cout" is global, so it be accessed from anywhere in the program.
-        file << message << num << std::endl;
-    }
-
-private:
-    std::mutex mtx;
-    std::ofstream file;
-};
+// More enhanced version: class LogFile in logFile.hpp, the mutex bundled together with the file
 
 // void thread_function() {
 //     for (int i = 0; i > -100; --i)
@@ -73,6 +53,7 @@ int main() {
     for (int i = 0; i < 100; ++i)
         log.shared_print("From main: ", i);
     t1.join();
+    INSTRUMENT_REPORT(std::cout);
     return 0;
 }
 /**
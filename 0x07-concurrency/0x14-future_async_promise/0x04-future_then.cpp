@@ -0,0 +1,119 @@
+// Chaining computations with continuations instead of blocking get() (continuationFuture.hpp)
+// 1. latency of a 10-stage chain: every stage adds 1 to the previous result.
+//    * std::async + get(): each stage is a thread parked in get() on the previous stage's future.
+//    * Future::then inline: each stage runs on the thread that completes the previous one.
+//    * Future::then on a ThreadPool: each stage is a task posted to the pool.
+// 2. the broadcast of 0x03-example.cpp with SharedFuture, plus when_all / when_any.
+// usage: ./a.out [number_of_chains]
+#include <iostream>
+#include <future>
+#include <vector>
+#include <chrono>
+#include <string>
+#include <stdexcept>
+#include "continuationFuture.hpp"
+
+const int stages = 10;
+
+int factorial(int n) {
+    int res = 1;
+    for (int i = 1; i <= n; i++) {
+        res *= i;
+    }
+    return res;
+}
+
+// returns the average time from "first value set" to "last stage done", in microseconds
+template <typename RunChain>
+void runBenchmark(const std::string& name, int chains, RunChain runChain) {
+    double totalUs = 0;
+    for (int c = 0; c < chains; ++c) {
+        totalUs += runChain();
+    }
+    std::cout << name << ": " << totalUs / chains << " us per " << stages << "-stage chain\n";
+}
+
+double blockingChain() {
+    std::promise<int> prom;
+    std::future<int> prev = prom.get_future();
+    for (int s = 0; s < stages; ++s) {
+        prev = std::async(std::launch::async, [](std::future<int> f) { return f.get() + 1; }, std::move(prev));
+    }
+    // every stage thread is now parked in get()
+    auto start = std::chrono::steady_clock::now();
+    prom.set_value(0);
+    int result = prev.get();
+    auto end = std::chrono::steady_clock::now();
+    if (result != stages) {
+        throw std::logic_error("wrong result");
+    }
+    return std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+template <typename E>
+double continuationChain(E& ex) {
+    Promise<int> prom;
+    Future<int> prev = prom.get_future();
+    for (int s = 0; s < stages; ++s) {
+        prev = prev.then(ex, [](int v) { return v + 1; });
+    }
+    // no thread is parked: the stages are just registered callbacks
+    auto start = std::chrono::steady_clock::now();
+    prom.set_value(0);
+    int result = prev.get();
+    auto end = std::chrono::steady_clock::now();
+    if (result != stages) {
+        throw std::logic_error("wrong result");
+    }
+    return std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        int chains = argc > 1 ? std::stoi(argv[1]) : 1000;
+        ThreadPool pool(4);
+        InlineExecutor inlineEx;
+
+        runBenchmark("std::async + blocking get()", chains, blockingChain);
+        runBenchmark("Future::then (inline)      ", chains, [&] { return continuationChain(inlineEx); });
+        runBenchmark("Future::then (ThreadPool)  ", chains, [&] { return continuationChain(pool); });
+
+        // broadcast: every consumer is a continuation, not a thread waiting in get()
+        Promise<int> prom;
+        SharedFuture<int> n = prom.get_future().share();
+        std::vector<Future<int>> results;
+        for (int i = 0; i < 3; ++i) {
+            results.push_back(n.then(pool, [i](const int& v) { return factorial(v + i); }));
+        }
+        prom.set_value(4);
+        Future<std::vector<int>> all = when_all(std::move(results));
+        for (int r : all.get()) {
+            std::cout << "when_all: " << r << "\n";
+        }
+
+        // an exception skips the value continuations and is seen by get()
+        Future<int> failed = makeReadyFuture(5)
+            .then([](int v) -> int { throw std::runtime_error("stage failed at " + std::to_string(v)); })
+            .then([](int v) { return v * 2; }); // never runs
+        try {
+            failed.get();
+        } catch (const std::exception& e) {
+            std::cout << "chain error: " << e.what() << "\n";
+        }
+
+        // the first of several to finish
+        Promise<int> slow, fast;
+        std::vector<Future<int>> candidates;
+        candidates.push_back(slow.get_future());
+        candidates.push_back(fast.get_future());
+        Future<WhenAnyResult<int>> first = when_any(std::move(candidates));
+        fast.set_value(factorial(5));
+        WhenAnyResult<int> winner = first.get();
+        std::cout << "when_any: future " << winner.index << " = " << winner.value << "\n";
+        slow.set_value(0);
+    } catch (const std::exception& e) {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,86 @@
+// std::async vs exec::async on a shared bounded pool (pooledAsync.hpp)
+// std::async(std::launch::async, ...) starts a new thread for every call (see 0x00-example.cpp).
+// For each way of launching, a child process (so the peak RSS of one does not hide the other) runs:
+// * latency: async + get() one call at a time, the time until the result is back;
+// * throughput: all the calls with up to `window` of them in flight, then the peak RSS of the process.
+// usage: ./a.out [number_of_calls] [window]
+#include <iostream>
+#include <future>
+#include <vector>
+#include <deque>
+#include <chrono>
+#include <string>
+#include "pooledAsync.hpp"
+#include "../processStats.hpp"
+
+int factorial(int n) {
+    int res = 1;
+    for (int i = 1; i <= n; i++) {
+        res *= i;
+    }
+    return res;
+}
+
+// `launch(n)` starts factorial(n) and returns a future
+template <typename Launch>
+void runBenchmark(const std::string& name, long calls, size_t window, Launch launch) {
+    long latencyCalls = std::max(1L, calls / 10);
+    long checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < latencyCalls; ++i) {
+        checksum += launch(static_cast<int>(i % 12)).get();
+    }
+    double latencyUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    std::deque<decltype(launch(0))> inFlight;
+    for (long i = 0; i < calls; ++i) {
+        if (inFlight.size() >= window) {
+            checksum += inFlight.front().get();
+            inFlight.pop_front();
+        }
+        inFlight.push_back(launch(static_cast<int>(i % 12)));
+    }
+    for (auto& f : inFlight) {
+        checksum += f.get();
+    }
+    double totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << name << ": latency " << latencyUs / latencyCalls << " us/call, " << calls << " calls in "
+              << totalMs << " ms (" << calls / totalMs * 1000 << " calls/s), peak RSS " << peakRssKb() / 1024.0
+              << " MB (checksum " << checksum << ")" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        long calls = argc > 1 ? std::stol(argv[1]) : 100'000;
+        size_t window = argc > 2 ? std::stoul(argv[2]) : 256;
+
+        inChildProcess([&] {
+            runBenchmark("std::async(launch::async)     ", calls, window,
+                         [](int n) { return std::async(std::launch::async, factorial, n); });
+        });
+        inChildProcess([&] {
+            runBenchmark("exec::async (shared pool)     ", calls, window,
+                         [](int n) { return exec::async(exec::defaultExecutor(), factorial, n); });
+        });
+        inChildProcess([&] {
+            runBenchmark("exec::async(inline_if_idle)   ", calls, window,
+                         [](int n) { return exec::async(exec::launch::inline_if_idle, factorial, n); });
+        });
+
+        // same future semantics: the exception thrown by the task comes out of get()
+        Future<int> failed = exec::async(exec::defaultExecutor(), [](int n) -> int {
+            throw std::invalid_argument("negative input: " + std::to_string(n));
+        }, -1);
+        try {
+            failed.get();
+        } catch (const std::exception& e) {
+            std::cout << "get() rethrows: " << e.what() << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,449 @@
+#ifndef CONTINUATION_FUTURE_HPP
+#define CONTINUATION_FUTURE_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+#include "../threadPool.hpp"
+
+// Promise<T> / Future<T> / SharedFuture<T> with continuations.
+// std::future only has a blocking get(), so every stage of a pipeline (and, with std::shared_future,
+// every consumer of a broadcast value) needs its own thread parked in get().
+// Here `fut.then(executor, fn)` registers fn to run when the value is there: the thread that sets the value
+// posts fn to the executor (or runs it right away with the inline executor), and nobody is parked.
+//
+// The continuation receives either the value, or the ready future itself (like the Concurrency TS),
+// which is the way to see (and handle) an exception:
+//     fut.then(pool, [](int v) { return v + 1; });                 // skipped if fut holds an exception
+//     fut.then(pool, [](Future<int> f) { try { f.get(); } ... });  // always runs
+// An exception thrown by fn ends up in the future returned by then().
+
+template <typename T> class Promise;
+template <typename T> class Future;
+template <typename T> class SharedFuture;
+
+namespace detail {
+
+template <typename T>
+using Stored = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+template <typename T>
+struct FutureState {
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool ready = false;
+    int waiters = 0;
+    std::optional<Stored<T>> value;
+    std::exception_ptr error;
+    std::vector<Task> continuations; // more than one only for SharedFuture
+
+    // runs `c` right away if the state is ready, else when it becomes ready
+    void addContinuation(Task c) {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (!ready) {
+                continuations.push_back(std::move(c));
+                return;
+            }
+        }
+        c();
+    }
+
+    // mtx must be held (and is released); value or error already stored
+    void finish(std::unique_lock<std::mutex>& lock) {
+        ready = true;
+        std::vector<Task> toRun = std::move(continuations);
+        bool wake = waiters > 0;
+        lock.unlock();
+        if (wake) {
+            cv.notify_all();
+        }
+        for (auto& c : toRun) {
+            c();
+        }
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mtx);
+        if (!ready) {
+            ++waiters;
+            cv.wait(lock, [this] { return ready; });
+            --waiters;
+        }
+    }
+};
+
+inline InlineExecutor& inlineExecutor() {
+    static InlineExecutor ex;
+    return ex;
+}
+
+// the type returned by fn when it is called as a continuation of Src (Future<T> or SharedFuture<T>)
+template <typename T, typename Src, typename Fn>
+auto continuationResult() {
+    if constexpr (std::is_invocable_v<Fn&, Src>) {
+        return std::type_identity<std::invoke_result_t<Fn&, Src>>{};
+    } else if constexpr (std::is_void_v<T>) {
+        return std::type_identity<std::invoke_result_t<Fn&>>{};
+    } else {
+        return std::type_identity<std::invoke_result_t<Fn&, decltype(std::declval<Src&>().get())>>{};
+    }
+}
+
+template <typename U, typename G>
+void setFrom(Promise<U>& p, G&& g) {
+    if constexpr (std::is_void_v<U>) {
+        g();
+        p.set_value();
+    } else {
+        p.set_value(g());
+    }
+}
+
+// calls fn on the ready `src`, stores the outcome into `next`
+template <typename T, typename Src, typename Fn, typename U>
+void runStage(Src src, Fn& fn, Promise<U>& next) {
+    try {
+        if constexpr (std::is_invocable_v<Fn&, Src>) {
+            setFrom(next, [&]() -> decltype(auto) { return fn(std::move(src)); });
+        } else if constexpr (std::is_void_v<T>) {
+            src.get(); // rethrows
+            setFrom(next, [&]() -> decltype(auto) { return fn(); });
+        } else {
+            setFrom(next, [&]() -> decltype(auto) { return fn(src.get()); });
+        }
+    } catch (...) {
+        next.set_exception(std::current_exception());
+    }
+}
+
+template <typename T, typename Src, Executor E, typename Fn>
+auto chain(std::shared_ptr<FutureState<T>> state, E& ex, Fn&& fn) {
+    using U = typename decltype(continuationResult<T, Src, std::decay_t<Fn>>())::type;
+    Promise<U> next;
+    Future<U> result = next.get_future();
+    FutureState<T>* raw = state.get();
+    // the continuation keeps the state alive until it runs (a short-lived cycle: finish() moves it out)
+    raw->addContinuation([state = std::move(state), &ex, fn = std::forward<Fn>(fn), next = std::move(next)]() mutable {
+        ex.post([state = std::move(state), fn = std::move(fn), next = std::move(next)]() mutable {
+            runStage<T>(Src(std::move(state)), fn, next);
+        });
+    });
+    return result;
+}
+
+} // namespace detail
+
+template <typename T>
+class Promise {
+private:
+    std::shared_ptr<detail::FutureState<T>> state_ = std::make_shared<detail::FutureState<T>>();
+    bool retrieved_ = false;
+
+    template <typename Store>
+    void complete(Store store) {
+        if (!state_) {
+            throw std::future_error(std::future_errc::no_state);
+        }
+        std::unique_lock<std::mutex> lock(state_->mtx);
+        if (state_->ready) {
+            throw std::future_error(std::future_errc::promise_already_satisfied);
+        }
+        store(*state_);
+        state_->finish(lock);
+    }
+
+public:
+    Promise() = default;
+    Promise(Promise&&) noexcept = default;
+    Promise& operator=(Promise&& other) noexcept {
+        if (this != &other) {
+            abandon();
+            state_ = std::move(other.state_);
+            retrieved_ = other.retrieved_;
+        }
+        return *this;
+    }
+    ~Promise() { abandon(); }
+
+    Future<T> get_future() {
+        if (!state_) {
+            throw std::future_error(std::future_errc::no_state);
+        }
+        if (retrieved_) {
+            throw std::future_error(std::future_errc::future_already_retrieved);
+        }
+        retrieved_ = true;
+        return Future<T>(state_);
+    }
+
+    template <typename... Args>
+    void set_value(Args&&... args) {
+        complete([&](detail::FutureState<T>& s) { s.value.emplace(std::forward<Args>(args)...); });
+    }
+
+    void set_exception(std::exception_ptr e) {
+        complete([&](detail::FutureState<T>& s) { s.error = std::move(e); });
+    }
+
+private:
+    // a promise destroyed without a value breaks it (as std::promise does)
+    void abandon() {
+        if (!state_) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(state_->mtx);
+        if (!state_->ready) {
+            state_->error = std::make_exception_ptr(std::future_error(std::future_errc::broken_promise));
+            state_->finish(lock);
+        }
+    }
+};
+
+template <typename T>
+class Future {
+private:
+    std::shared_ptr<detail::FutureState<T>> state_;
+
+public:
+    Future() = default;
+    // used by the library; user code gets a Future from Promise::get_future() or then()
+    explicit Future(std::shared_ptr<detail::FutureState<T>> state) : state_(std::move(state)) {}
+
+    Future(Future&&) noexcept = default;
+    Future& operator=(Future&&) noexcept = default;
+
+    bool valid() const noexcept { return state_ != nullptr; }
+
+    bool isReady() const {
+        std::lock_guard<std::mutex> lock(state_->mtx);
+        return state_->ready;
+    }
+
+    void wait() const { state_->wait(); }
+
+    // blocks until ready; like std::future::get() it can be called only once
+    T get() {
+        if (!state_) {
+            throw std::future_error(std::future_errc::no_state);
+        }
+        auto state = std::move(state_);
+        state->wait();
+        if (state->error) {
+            std::rethrow_exception(state->error);
+        }
+        if constexpr (!std::is_void_v<T>) {
+            return std::move(*state->value);
+        }
+    }
+
+    SharedFuture<T> share() { return SharedFuture<T>(std::move(state_)); }
+
+    // fn runs on `ex` once the value is ready; the future is consumed
+    template <Executor E, typename Fn>
+    auto then(E& ex, Fn&& fn) {
+        if (!state_) {
+            throw std::future_error(std::future_errc::no_state);
+        }
+        return detail::chain<T, Future<T>>(std::move(state_), ex, std::forward<Fn>(fn));
+    }
+
+    // fn runs inline: on the thread that sets the value, or right here if it is already set
+    template <typename Fn>
+    auto then(Fn&& fn) {
+        return then(detail::inlineExecutor(), std::forward<Fn>(fn));
+    }
+};
+
+// SharedFuture<T>: copyable, get() can be called many times, and every copy can attach its own continuations.
+// This is the broadcast case of 0x03-example.cpp without one parked thread per consumer.
+template <typename T>
+class SharedFuture {
+private:
+    std::shared_ptr<detail::FutureState<T>> state_;
+
+public:
+    SharedFuture() = default;
+    explicit SharedFuture(std::shared_ptr<detail::FutureState<T>> state) : state_(std::move(state)) {}
+
+    bool valid() const noexcept { return state_ != nullptr; }
+
+    bool isReady() const {
+        std::lock_guard<std::mutex> lock(state_->mtx);
+        return state_->ready;
+    }
+
+    void wait() const { state_->wait(); }
+
+    std::add_lvalue_reference_t<const T> get() const {
+        if (!state_) {
+            throw std::future_error(std::future_errc::no_state);
+        }
+        state_->wait();
+        if (state_->error) {
+            std::rethrow_exception(state_->error);
+        }
+        if constexpr (!std::is_void_v<T>) {
+            return *state_->value;
+        }
+    }
+
+    // fn receives `const T&` (or the SharedFuture); the SharedFuture stays valid
+    template <Executor E, typename Fn>
+    auto then(E& ex, Fn&& fn) const {
+        if (!state_) {
+            throw std::future_error(std::future_errc::no_state);
+        }
+        return detail::chain<T, SharedFuture<T>>(state_, ex, std::forward<Fn>(fn));
+    }
+
+    template <typename Fn>
+    auto then(Fn&& fn) const {
+        return then(detail::inlineExecutor(), std::forward<Fn>(fn));
+    }
+};
+
+template <typename T>
+Future<std::decay_t<T>> makeReadyFuture(T&& value) {
+    Promise<std::decay_t<T>> p;
+    p.set_value(std::forward<T>(value));
+    return p.get_future();
+}
+
+inline Future<void> makeReadyFuture() {
+    Promise<void> p;
+    p.set_value();
+    return p.get_future();
+}
+
+template <typename T>
+using WhenAllResult = std::conditional_t<std::is_void_v<T>, void, std::vector<T>>;
+
+// Ready when every future is ready: the values in input order (nothing for Future<void>).
+// The first exception completes the result right away; the remaining values are dropped.
+template <typename T>
+Future<WhenAllResult<T>> when_all(std::vector<Future<T>> futures) {
+    struct Shared {
+        std::mutex mtx;
+        std::vector<std::optional<detail::Stored<T>>> values;
+        size_t remaining;
+        bool done = false;
+        Promise<WhenAllResult<T>> promise;
+    };
+    auto shared = std::make_shared<Shared>();
+    shared->values.resize(futures.size());
+    shared->remaining = futures.size();
+    Future<WhenAllResult<T>> result = shared->promise.get_future();
+
+    auto completeWithValues = [](Shared& s) {
+        if constexpr (std::is_void_v<T>) {
+            s.promise.set_value();
+        } else {
+            std::vector<T> out;
+            out.reserve(s.values.size());
+            for (auto& v : s.values) {
+                out.push_back(std::move(*v));
+            }
+            s.promise.set_value(std::move(out));
+        }
+    };
+    if (futures.empty()) {
+        completeWithValues(*shared);
+        return result;
+    }
+
+    for (size_t i = 0; i < futures.size(); ++i) {
+        futures[i].then([shared, i, completeWithValues](Future<T> f) {
+            std::exception_ptr error;
+            std::optional<detail::Stored<T>> value;
+            try {
+                if constexpr (std::is_void_v<T>) {
+                    f.get();
+                    value.emplace();
+                } else {
+                    value.emplace(f.get());
+                }
+            } catch (...) {
+                error = std::current_exception();
+            }
+            bool last = false, fail = false;
+            {
+                std::lock_guard<std::mutex> lock(shared->mtx);
+                if (shared->done) {
+                    return;
+                }
+                if (error) {
+                    shared->done = fail = true;
+                } else {
+                    shared->values[i] = std::move(value);
+                    last = --shared->remaining == 0;
+                    shared->done = last;
+                }
+            }
+            if (fail) {
+                shared->promise.set_exception(error);
+            } else if (last) {
+                completeWithValues(*shared); // every value is stored, nobody else touches them now
+            }
+        });
+    }
+    return result;
+}
+
+template <typename T>
+struct WhenAnyResult {
+    size_t index;
+    T value;
+};
+template <>
+struct WhenAnyResult<void> {
+    size_t index;
+};
+
+// Ready when the first future is ready: its index and value (or its exception).
+template <typename T>
+Future<WhenAnyResult<T>> when_any(std::vector<Future<T>> futures) {
+    if (futures.empty()) {
+        throw std::invalid_argument("when_any: no futures");
+    }
+    struct Shared {
+        std::mutex mtx;
+        bool done = false;
+        Promise<WhenAnyResult<T>> promise;
+    };
+    auto shared = std::make_shared<Shared>();
+    Future<WhenAnyResult<T>> result = shared->promise.get_future();
+    for (size_t i = 0; i < futures.size(); ++i) {
+        futures[i].then([shared, i](Future<T> f) {
+            {
+                std::lock_guard<std::mutex> lock(shared->mtx);
+                if (shared->done) {
+                    return;
+                }
+                shared->done = true;
+            }
+            try {
+                if constexpr (std::is_void_v<T>) {
+                    f.get();
+                    shared->promise.set_value(WhenAnyResult<void>{i});
+                } else {
+                    shared->promise.set_value(WhenAnyResult<T>{i, f.get()});
+                }
+            } catch (...) {
+                shared->promise.set_exception(std::current_exception());
+            }
+        });
+    }
+    return result;
+}
+
+#endif // CONTINUATION_FUTURE_HPP
@@ -0,0 +1,89 @@
+#ifndef POOLED_ASYNC_HPP
+#define POOLED_ASYNC_HPP
+
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "continuationFuture.hpp"
+
+// exec::async(executor, f, args...): like std::async(std::launch::async, f, args...), but f runs as a task
+// on an executor instead of on a brand new thread, so the cost of a call is a queue push instead of a
+// thread creation (a clone() system call, a stack mmap, and the same again to tear it down).
+// The result is a Future (continuationFuture.hpp): get() blocks and rethrows like std::future::get(),
+// a task that never runs breaks the promise, and then()/when_all() work on it too.
+// Like std::async, the arguments are copied (decayed) into the task; use std::ref to pass a reference.
+namespace exec {
+
+enum class launch {
+    async,          // always queued on the executor (a bounded pool makes the caller wait while it is full)
+    inline_if_idle, // handed to an idle worker if there is one, otherwise run right here on the calling thread:
+                    // the task never waits in a queue, and a busy pool pushes the work back to its callers
+};
+
+// the shared pool used when no executor is given: one worker per core, at most 64 queued tasks per worker
+inline ThreadPool& defaultExecutor() {
+    static ThreadPool pool(std::thread::hardware_concurrency(), 64 * std::max(1u, std::thread::hardware_concurrency()));
+    return pool;
+}
+
+namespace detail {
+
+template <typename Fn, typename... Args>
+using AsyncResult = std::invoke_result_t<std::decay_t<Fn>, std::decay_t<Args>...>;
+
+// a Task that runs f(args...) and stores the outcome in a promise
+template <typename Fn, typename... Args>
+Task makeAsyncTask(Promise<AsyncResult<Fn, Args...>> promise, Fn&& fn, Args&&... args) {
+    return [promise = std::move(promise), fn = std::forward<Fn>(fn),
+            args = std::make_tuple(std::forward<Args>(args)...)]() mutable {
+        try {
+            if constexpr (std::is_void_v<AsyncResult<Fn, Args...>>) {
+                std::apply(std::move(fn), std::move(args));
+                promise.set_value();
+            } else {
+                promise.set_value(std::apply(std::move(fn), std::move(args)));
+            }
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+        }
+    };
+}
+
+} // namespace detail
+
+template <Executor E, typename Fn, typename... Args>
+Future<detail::AsyncResult<Fn, Args...>> async(launch policy, E& ex, Fn&& fn, Args&&... args) {
+    Promise<detail::AsyncResult<Fn, Args...>> promise;
+    auto future = promise.get_future();
+    Task task = detail::makeAsyncTask(std::move(promise), std::forward<Fn>(fn), std::forward<Args>(args)...);
+    if (policy == launch::inline_if_idle) {
+        if constexpr (requires { ex.tryPostToIdle(task); }) {
+            if (!ex.tryPostToIdle(task)) {
+                task();
+            }
+        } else {
+            task(); // an executor that can not tell whether it is idle
+        }
+    } else {
+        ex.post(std::move(task));
+    }
+    return future;
+}
+
+template <Executor E, typename Fn, typename... Args>
+Future<detail::AsyncResult<Fn, Args...>> async(E& ex, Fn&& fn, Args&&... args) {
+    return async(launch::async, ex, std::forward<Fn>(fn), std::forward<Args>(args)...);
+}
+
+template <typename Fn, typename... Args>
+Future<detail::AsyncResult<Fn, Args...>> async(launch policy, Fn&& fn, Args&&... args) {
+    return async(policy, defaultExecutor(), std::forward<Fn>(fn), std::forward<Args>(args)...);
+}
+
+} // namespace exec
+
+#endif // POOLED_ASYNC_HPP
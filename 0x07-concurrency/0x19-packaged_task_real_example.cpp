@@ -7,6 +7,7 @@
 #include <chrono>
 #include <vector>
 #include <functional>
+#include "scopedTimer.hpp"
 
 // Simulate a task queue that holds packaged tasks
 std::deque<std::packaged_task<std::string()>> task_q;
@@ -35,12 +36,18 @@ void worker_thread(int worker_id) {
         // Execute the task
         // std::string result = task.get_future().get();
         // std::string result = task();
-        task();
+        {
+            SCOPED_TIMER("worker_thread task");
+            task();
+        }
         // std::cout << "Worker " << worker_id << " finished task."<< std::endl;
     }
 }
 
 int main() {
+    // the workers never exit, so with instrumentation on the timers are reported every few seconds
+    INSTRUMENT_PERIODIC_REPORT(std::cerr, std::chrono::seconds(5));
+
     // Start worker threads
     const int num_workers = 3;
     std::vector<std::thread> workers;
@@ -0,0 +1,113 @@
+// Lazy initialization with a cheaper fast path than std::call_once
+// In 0x11-lazy_initialization.cpp `LogFile::shared_print` calls std::call_once on every log line.
+// OnceCell / Lazy (onceCell.hpp) pay one acquire load once the value exists, and threadCached<> pays
+// only a thread_local read.
+// This program benchmarks the accessors from many threads, then shows a fallible initialization with retry.
+// usage: ./a.out [number_of_threads] [calls_per_thread]   (the LogFile writes /tmp/once_cell_log.txt)
+#include <iostream>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <fstream>
+#include <optional>
+#include "onceCell.hpp"
+
+int expensiveInit() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10)); // e.g. opening a file, reading a config
+    return 42;
+}
+
+// 1. std::call_once (like 0x11-lazy_initialization.cpp)
+std::once_flag flag;
+int onceValue;
+int& viaCallOnce() {
+    std::call_once(flag, [] { onceValue = expensiveInit(); });
+    return onceValue;
+}
+
+// 2. function-local static ("magic statics": the compiler generates a guard variable)
+int& viaStatic() {
+    static int value = expensiveInit();
+    return value;
+}
+
+// 3. OnceCell
+OnceCell<int> cell;
+int& viaOnceCell() {
+    return cell.getOrInit(expensiveInit);
+}
+
+// 4. Lazy + thread-local cache
+Lazy lazyValue(expensiveInit); // Lazy<int, int (*)()>
+int& viaThreadCached() {
+    return threadCached<lazyValue>();
+}
+
+template <typename Accessor>
+void runBenchmark(const std::string& name, int threads, long calls, Accessor get) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    std::vector<long> sums(threads);
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            long sum = 0;
+            for (long i = 0; i < calls; ++i) {
+                sum += get();
+            }
+            sums[t] = sum;
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    long total = 0;
+    for (long s : sums) {
+        total += s;
+    }
+    std::cout << name << ": " << ns / (static_cast<double>(calls) * threads) << " ns/call (checksum " << total << ")\n";
+}
+
+// LogFile from 0x11-lazy_initialization.cpp, with OnceCell instead of std::call_once
+class LogFile {
+private:
+    std::mutex mtx;
+    OnceCell<std::ofstream> file;
+public:
+    void shared_print(const std::string& message, const int& num) {
+        std::ofstream& f = file.getOrInit([] { return std::ofstream("/tmp/once_cell_log.txt"); }); // opened only once
+        std::unique_lock<std::mutex> locker(mtx);
+        f << message << num << "\n";
+    }
+};
+
+int main(int argc, char* argv[]) {
+    int threads = argc > 1 ? std::stoi(argv[1]) : 16;
+    long calls = argc > 2 ? std::stol(argv[2]) : 100'000'000 / threads;
+
+    std::cout << threads << " threads x " << calls << " calls\n";
+    runBenchmark("std::call_once       ", threads, calls, viaCallOnce);
+    runBenchmark("function-local static", threads, calls, viaStatic);
+    runBenchmark("OnceCell::getOrInit  ", threads, calls, viaOnceCell);
+    runBenchmark("threadCached<Lazy>   ", threads, calls, viaThreadCached);
+
+    // fallible initialization: the first two attempts fail, the cell stays empty and the next call retries
+    OnceCell<std::string> connection;
+    int attempts = 0;
+    auto connect = [&]() -> std::optional<std::string> {
+        if (++attempts < 3) {
+            return std::nullopt; // e.g. the server is not up yet
+        }
+        return "connected after " + std::to_string(attempts) + " attempts";
+    };
+    for (int i = 0; i < 5; ++i) {
+        std::string* c = connection.tryGetOrInit(connect);
+        std::cout << "call " << i << ": " << (c ? *c : "not initialized yet") << "\n";
+    }
+
+    LogFile log;
+    log.shared_print("From main: ", 1);
+    return 0;
+}
@@ -0,0 +1,119 @@
+// Bounded producer/consumer buffer with batch push/pop
+// 0x13-condition_variables.cpp pushes one int at a time into a std::deque and wakes the consumer for every item.
+// BoundedBuffer (boundedBuffer.hpp) adds a capacity limit, push_batch/pop_batch and close/drain for shutdown.
+// This program moves the same number of "sensor samples" both ways and reports items/s, how many times the
+// consumer had to sleep, and the context switches measured by the OS.
+// usage: ./a.out [number_of_items] [batch_size]
+#include <iostream>
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <vector>
+#include <chrono>
+#include <string>
+#include <condition_variable>
+#include <sys/resource.h>
+#include "boundedBuffer.hpp"
+
+struct Sample {
+    int sensor;
+    double value;
+};
+
+long contextSwitches() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_nvcsw + usage.ru_nivcsw;
+}
+
+struct Result {
+    double sum = 0;
+    long sleeps = 0;
+};
+
+// the pattern of 0x13-condition_variables.cpp (without the sleep in the producer)
+Result runPerItem(long items) {
+    std::deque<Sample> buffer;
+    std::mutex mtx;
+    std::condition_variable condition_var;
+    Result result;
+
+    std::thread producer([&] {
+        for (long i = 0; i < items; ++i) {
+            std::unique_lock<std::mutex> lock(mtx);
+            buffer.push_front({static_cast<int>(i % 8), 1.0});
+            lock.unlock();
+            condition_var.notify_one(); // one notification per item
+        }
+    });
+    std::thread consumer([&] {
+        for (long received = 0; received < items; ++received) {
+            std::unique_lock<std::mutex> lock(mtx);
+            if (buffer.empty()) {
+                result.sleeps++;
+            }
+            condition_var.wait(lock, [&] { return !buffer.empty(); });
+            result.sum += buffer.back().value;
+            buffer.pop_back();
+        }
+    });
+    producer.join();
+    consumer.join();
+    return result;
+}
+
+Result runBatched(long items, size_t batch) {
+    BoundedBuffer<Sample> buffer(4 * batch);
+    Result result;
+
+    std::thread producer([&] {
+        std::vector<Sample> samples;
+        for (long i = 0; i < items; ++i) {
+            samples.push_back({static_cast<int>(i % 8), 1.0});
+            if (samples.size() == batch) {
+                buffer.push_batch(samples.begin(), samples.end());
+                samples.clear();
+            }
+        }
+        buffer.push_batch(samples.begin(), samples.end());
+        buffer.close(); // no more samples: the consumer drains the buffer and stops
+    });
+    std::thread consumer([&] {
+        std::vector<Sample> received;
+        while (true) {
+            received.clear();
+            size_t n = buffer.pop_batch(received, batch, std::chrono::milliseconds(100));
+            if (n == 0 && buffer.drained()) {
+                break;
+            }
+            for (const Sample& s : received) {
+                result.sum += s.value;
+            }
+        }
+    });
+    producer.join();
+    consumer.join();
+    result.sleeps = static_cast<long>(buffer.consumerWaits());
+    return result;
+}
+
+template <typename Fn>
+void runBenchmark(const std::string& name, long items, Fn fn) {
+    long switchesBefore = contextSwitches();
+    auto start = std::chrono::steady_clock::now();
+    Result r = fn();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    long switches = contextSwitches() - switchesBefore;
+    std::cout << name << ": " << items / seconds / 1e6 << " M items/s, "
+              << r.sleeps << " consumer sleeps (" << r.sleeps / seconds << "/s), "
+              << switches << " context switches (" << switches / seconds << "/s), checksum " << r.sum << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    long items = argc > 1 ? std::stol(argv[1]) : 10'000'000;
+    size_t batch = argc > 2 ? std::stoul(argv[2]) : 256;
+
+    runBenchmark("deque + notify per item", items, [&] { return runPerItem(items); });
+    runBenchmark("BoundedBuffer, batch " + std::to_string(batch), items, [&] { return runBatched(items, batch); });
+    return 0;
+}
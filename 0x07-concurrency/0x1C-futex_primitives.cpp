@@ -0,0 +1,152 @@
+// Event, CountingSemaphore and Latch on top of std::atomic::wait/notify (futex on Linux)
+// 1. ping-pong: two threads hand a token back and forth; we measure the round trip latency with
+//    condition_variable + mutex and with the atomic based primitives (syncPrimitives.hpp).
+// 2. the task queue of 0x18-packaged_task.cpp / 0x19-packaged_task_real_example.cpp, where the
+//    "task available" condition is a CountingSemaphore, completion is a Latch and shutdown is an Event.
+// usage: ./a.out [number_of_round_trips]
+#include <iostream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <functional>
+#include <vector>
+#include <chrono>
+#include <string>
+#include "syncPrimitives.hpp"
+
+template <typename Fn>
+void runPingPong(const std::string& name, long rounds, Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn(rounds);
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name << ": " << ns / rounds << " ns per round trip\n";
+}
+
+void pingPongConditionVariable(long rounds) {
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool ping = false; // true: the ball is on the pong side
+
+    std::thread pong([&] {
+        for (long i = 0; i < rounds; ++i) {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [&] { return ping; });
+            ping = false;
+            lock.unlock();
+            cv.notify_one();
+        }
+    });
+    for (long i = 0; i < rounds; ++i) {
+        std::unique_lock<std::mutex> lock(mtx);
+        ping = true;
+        lock.unlock();
+        cv.notify_one();
+        lock.lock();
+        cv.wait(lock, [&] { return !ping; });
+    }
+    pong.join();
+}
+
+void pingPongSemaphore(long rounds) {
+    CountingSemaphore toPong(0), toPing(0);
+    std::thread pong([&] {
+        for (long i = 0; i < rounds; ++i) {
+            toPong.acquire();
+            toPing.release();
+        }
+    });
+    for (long i = 0; i < rounds; ++i) {
+        toPong.release();
+        toPing.acquire();
+    }
+    pong.join();
+}
+
+void pingPongEvent(long rounds) {
+    Event ping, pong;
+    std::thread other([&] {
+        for (long i = 0; i < rounds; ++i) {
+            ping.wait();
+            ping.reset();
+            pong.set();
+        }
+    });
+    for (long i = 0; i < rounds; ++i) {
+        ping.set();
+        pong.wait();
+        pong.reset();
+    }
+    other.join();
+}
+
+// ---- the packaged_task queue with the new primitives ----
+std::deque<std::packaged_task<int()>> task_q;
+std::mutex task_q_mutex;          // still protects the deque itself
+CountingSemaphore tasksAvailable; // one permit per task in the queue (replaces the condition variable)
+Event shutdown;
+
+int factorial(int n) {
+    int result = 1;
+    for (int i = 1; i <= n; ++i) {
+        result *= i;
+    }
+    return result;
+}
+
+void worker_thread(Latch& done) {
+    while (true) {
+        tasksAvailable.acquire();
+        std::packaged_task<int()> task;
+        {
+            std::lock_guard<std::mutex> lock(task_q_mutex);
+            if (task_q.empty() && shutdown.isSet()) {
+                break; // the queue is drained and we were asked to stop
+            }
+            task = std::move(task_q.front());
+            task_q.pop_front();
+        }
+        task();
+        done.count_down();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    long rounds = argc > 1 ? std::stol(argv[1]) : 200'000;
+
+    runPingPong("condition_variable + mutex", rounds, pingPongConditionVariable);
+    runPingPong("CountingSemaphore         ", rounds, pingPongSemaphore);
+    runPingPong("Event                     ", rounds, pingPongEvent);
+
+    const int num_workers = 3;
+    const int num_tasks = 10;
+    Latch allDone(num_tasks);
+    std::vector<std::thread> workers;
+    for (int i = 0; i < num_workers; ++i) {
+        workers.emplace_back(worker_thread, std::ref(allDone));
+    }
+
+    std::vector<std::future<int>> results;
+    for (int i = 1; i <= num_tasks; ++i) {
+        std::packaged_task<int()> t(std::bind(factorial, i));
+        results.push_back(t.get_future());
+        {
+            std::lock_guard<std::mutex> lock(task_q_mutex);
+            task_q.push_back(std::move(t));
+        }
+        tasksAvailable.release();
+    }
+
+    allDone.wait(); // every task has run
+    for (int i = 0; i < num_tasks; ++i) {
+        std::cout << "factorial(" << i + 1 << ") = " << results[i].get() << "\n";
+    }
+
+    shutdown.set();
+    tasksAvailable.release(num_workers); // wake every worker with an empty queue
+    for (auto& w : workers) {
+        w.join();
+    }
+    return 0;
+}
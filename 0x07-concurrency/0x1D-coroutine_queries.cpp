@@ -0,0 +1,96 @@
+// query_database of 0x19-packaged_task_real_example.cpp with C++20 coroutines (coroTask.hpp)
+// The simulated query sleeps for 2 seconds. With one thread per query, 10k queries in flight means 10k threads
+// doing nothing but sleeping. As a coroutine, a waiting query is a small heap-allocated frame in the
+// scheduler's timer heap, and a few threads run all of them.
+// Each model runs in a child process, so the peak RSS of one does not hide the other.
+// usage: ./a.out [number_of_queries] [query_milliseconds] [scheduler_threads]
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <system_error>
+#include "coroTask.hpp"
+#include "processStats.hpp"
+
+// Function simulating a database query (as in 0x19)
+std::string query_database(int query_id, std::chrono::milliseconds delay) {
+    std::this_thread::sleep_for(delay); // Simulating a delay
+    return "Result of query " + std::to_string(query_id);
+}
+
+// the same query as a coroutine
+coro::Task<std::string> query_database_async(int query_id, std::chrono::milliseconds delay) {
+    co_await coro::sleep_for(delay); // the thread goes back to the scheduler meanwhile
+    co_return "Result of query " + std::to_string(query_id);
+}
+
+void report(const std::string& name, std::chrono::steady_clock::time_point start, const std::vector<std::string>& results) {
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    size_t bytes = 0;
+    for (auto& r : results) {
+        bytes += r.size();
+    }
+    std::cout << name << ": " << results.size() << " queries in " << s << " s, peak RSS " << peakRssKb() / 1024.0
+              << " MB (" << bytes << " bytes of results)" << std::endl;
+}
+
+void threadPerQuery(int queries, std::chrono::milliseconds delay) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::string> results(queries);
+    std::vector<std::thread> threads;
+    threads.reserve(queries);
+    try {
+        for (int i = 0; i < queries; ++i) {
+            threads.emplace_back([&results, i, delay] { results[i] = query_database(i + 1, delay); });
+        }
+    } catch (const std::system_error& e) {
+        std::cout << "thread per query: could only start " << threads.size() << " threads (" << e.what() << ")\n";
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    results.resize(threads.size());
+    report("thread per query        ", start, results);
+}
+
+void coroutines(int queries, std::chrono::milliseconds delay, size_t schedulerThreads) {
+    auto start = std::chrono::steady_clock::now();
+    coro::Scheduler scheduler(schedulerThreads);
+    std::vector<coro::Task<std::string>> tasks;
+    tasks.reserve(queries);
+    for (int i = 0; i < queries; ++i) {
+        tasks.push_back(query_database_async(i + 1, delay));
+    }
+    std::vector<std::string> results = coro::syncWait(scheduler, coro::when_all(std::move(tasks)));
+    report("coroutines (" + std::to_string(schedulerThreads) + " threads)   ", start, results);
+    std::cout << "first: " << results.front() << ", last: " << results.back() << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        int queries = argc > 1 ? std::stoi(argv[1]) : 10'000;
+        std::chrono::milliseconds delay(argc > 2 ? std::stol(argv[2]) : 2000);
+        size_t schedulerThreads = argc > 3 ? std::stoul(argv[3]) : 4;
+
+        std::cout << queries << " concurrent queries of " << delay.count() << " ms" << std::endl;
+        inChildProcess([&] { threadPerQuery(queries, delay); });
+        inChildProcess([&] { coroutines(queries, delay, schedulerThreads); });
+
+        // an exception thrown in a coroutine comes out of co_await (and syncWait)
+        coro::Scheduler scheduler(1);
+        auto failing = []() -> coro::Task<int> {
+            co_await coro::sleep_for(std::chrono::milliseconds(1));
+            throw std::runtime_error("connection lost");
+        };
+        try {
+            coro::syncWait(scheduler, failing());
+        } catch (const std::exception& e) {
+            std::cout << "query failed: " << e.what() << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
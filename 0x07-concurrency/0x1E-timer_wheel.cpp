@@ -0,0 +1,158 @@
+// Delayed and periodic callbacks with a hierarchical timer wheel (timerWheel.hpp)
+// 0x13, 0x19 and the ThreadRAII demo of 0x04-thread.cpp wait with std::this_thread::sleep_for, so every pending
+// delay (a retry backoff, a timeout) keeps a thread asleep. A timer wheel keeps them as small nodes in slots
+// and one thread (or the caller) advances the wheel.
+// 1. benchmark: insert N timers (random delays up to `max_delay_ticks`), cancel half of them, then fire the rest.
+//    The same is done with a std::multimap ordered by expiry (O(log n) insert) for comparison.
+// 2. a retry with exponential backoff, a periodic heartbeat and a cancelled timeout on a ThreadPool.
+// usage: ./a.out [number_of_timers] [max_delay_ticks]
+#include <iostream>
+#include <vector>
+#include <map>
+#include <random>
+#include <chrono>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <functional>
+#include "timerWheel.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+double nsSince(Clock::time_point start, long n) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / n;
+}
+
+// the usual alternative: timers ordered by expiry in a balanced tree
+class MapTimers {
+private:
+    std::multimap<uint64_t, Task> timers_;
+    uint64_t current_ = 0;
+
+public:
+    using TimerId = std::multimap<uint64_t, Task>::iterator;
+    TimerId schedule(uint64_t ticks, Task fn) { return timers_.emplace(current_ + ticks, std::move(fn)); }
+    void cancel(TimerId id) { timers_.erase(id); }
+    size_t advance(uint64_t ticks) {
+        size_t fired = 0;
+        current_ += ticks;
+        while (!timers_.empty() && timers_.begin()->first <= current_) {
+            Task t = std::move(timers_.begin()->second);
+            timers_.erase(timers_.begin());
+            t();
+            ++fired;
+        }
+        return fired;
+    }
+};
+
+void benchmarkWheel(const std::vector<uint64_t>& delays, const std::vector<size_t>& cancelOrder, uint64_t maxDelay) {
+    InlineExecutor inlineEx;
+    TimerWheel<InlineExecutor> wheel(inlineEx, std::chrono::milliseconds(1));
+    long fired = 0;
+    long n = static_cast<long>(delays.size());
+    std::vector<TimerWheel<InlineExecutor>::TimerId> ids;
+    ids.reserve(delays.size());
+
+    auto start = Clock::now();
+    for (uint64_t d : delays) {
+        ids.push_back(wheel.schedule(std::chrono::milliseconds(d), [&fired] { ++fired; }));
+    }
+    double insertNs = nsSince(start, n);
+
+    start = Clock::now();
+    for (size_t i : cancelOrder) {
+        wheel.cancel(ids[i]);
+    }
+    double cancelNs = nsSince(start, static_cast<long>(cancelOrder.size()));
+
+    start = Clock::now();
+    size_t posted = wheel.advance(maxDelay);
+    double fireNs = nsSince(start, std::max<long>(1, fired));
+
+    std::cout << "TimerWheel   : insert " << insertNs << " ns, cancel " << cancelNs << " ns, fire " << fireNs
+              << " ns per timer (" << fired << " fired, " << posted << " posted, " << wheel.size() << " left)\n";
+}
+
+void benchmarkMap(const std::vector<uint64_t>& delays, const std::vector<size_t>& cancelOrder, uint64_t maxDelay) {
+    MapTimers timers;
+    long fired = 0;
+    long n = static_cast<long>(delays.size());
+    std::vector<MapTimers::TimerId> ids;
+    ids.reserve(delays.size());
+
+    auto start = Clock::now();
+    for (uint64_t d : delays) {
+        ids.push_back(timers.schedule(d, [&fired] { ++fired; }));
+    }
+    double insertNs = nsSince(start, n);
+
+    start = Clock::now();
+    for (size_t i : cancelOrder) {
+        timers.cancel(ids[i]);
+    }
+    double cancelNs = nsSince(start, static_cast<long>(cancelOrder.size()));
+
+    start = Clock::now();
+    timers.advance(maxDelay);
+    double fireNs = nsSince(start, std::max<long>(1, fired));
+
+    std::cout << "std::multimap: insert " << insertNs << " ns, cancel " << cancelNs << " ns, fire " << fireNs
+              << " ns per timer (" << fired << " fired)\n";
+}
+
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 1'000'000;
+    uint64_t maxDelay = argc > 2 ? std::stoull(argv[2]) : 600'000; // 10 minutes of 1ms ticks
+
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<uint64_t> dist(1, maxDelay);
+    std::vector<uint64_t> delays(n);
+    for (auto& d : delays) {
+        d = dist(rng);
+    }
+    std::vector<size_t> cancelOrder(n);
+    for (size_t i = 0; i < n; ++i) {
+        cancelOrder[i] = i;
+    }
+    std::shuffle(cancelOrder.begin(), cancelOrder.end(), rng);
+    cancelOrder.resize(n / 2); // most timeouts are cancelled before they fire
+
+    std::cout << n << " timers, delays up to " << maxDelay << " ticks, " << cancelOrder.size() << " cancelled\n";
+    benchmarkWheel(delays, cancelOrder, maxDelay);
+    benchmarkMap(delays, cancelOrder, maxDelay);
+
+    // real time: callbacks run on a pool, the wheel advances on its own thread
+    ThreadPool pool(2);
+    TimerWheel<ThreadPool> wheel(pool, std::chrono::milliseconds(1));
+    wheel.start();
+
+    std::atomic<int> beats{0};
+    auto heartbeat = wheel.schedulePeriodic(std::chrono::milliseconds(20), [&beats] { ++beats; });
+
+    // a request that fails three times, retried after 10ms, 20ms, 40ms (no thread sleeps in between)
+    std::atomic<bool> done{false};
+    std::function<void(int)> attempt = [&](int n) {
+        if (n < 3) {
+            auto backoff = std::chrono::milliseconds(10 << n);
+            std::cout << "attempt " << n << " failed, retry in " << backoff.count() << " ms" << std::endl;
+            wheel.schedule(backoff, [&attempt, n] { attempt(n + 1); });
+        } else {
+            std::cout << "attempt " << n << " succeeded" << std::endl;
+            done = true;
+        }
+    };
+    auto timeout = wheel.schedule(std::chrono::seconds(5), [] { std::cout << "timed out!" << std::endl; });
+    attempt(0);
+
+    while (!done) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    std::cout << "timeout cancelled: " << std::boolalpha << wheel.cancel(timeout) << std::endl;
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    wheel.cancel(heartbeat);
+    wheel.stop();
+    std::cout << "heartbeats: " << beats << std::endl;
+    return 0;
+}
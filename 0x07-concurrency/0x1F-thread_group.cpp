@@ -0,0 +1,110 @@
+// ThreadGroup (threadGroup.hpp): std::jthread workers with cooperative cancellation, CPU pinning, names,
+// and a join with a deadline.
+// 1. one pinned worker per allowed CPU consumes jobs from a queue; shutdown wakes the idle workers through their
+//    std::stop_token, and we measure how long the whole group takes to stop.
+// 2. a worker that ignores its stop_token: joinFor() gives up at the deadline instead of hanging.
+// 3. pinning to a CPU that does not exist is reported by spawn().
+// usage: ./a.out [number_of_jobs]
+#include <iostream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <chrono>
+#include <string>
+#include <sched.h>
+#include "threadGroup.hpp"
+
+std::deque<int> jobs;
+std::mutex jobs_mutex;
+std::condition_variable_any jobs_cv; // _any: its wait() also returns when stop is requested
+
+void worker(std::stop_token token, size_t index, std::vector<int>& done) {
+    while (true) {
+        int job;
+        {
+            std::unique_lock<std::mutex> lock(jobs_mutex);
+            // returns false when stop was requested (and there is no job)
+            if (!jobs_cv.wait(lock, token, [] { return !jobs.empty(); })) {
+                return;
+            }
+            job = jobs.front();
+            jobs.pop_front();
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(200 * (job % 5))); // some work
+        std::lock_guard<std::mutex> lock(jobs_mutex);
+        done[index]++;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        int numJobs = argc > 1 ? std::stoi(argv[1]) : 200;
+        std::vector<int> cpus = allowedCpus();
+        std::cout << "allowed CPUs:";
+        for (int c : cpus) {
+            std::cout << " " << c;
+        }
+        std::cout << "\n";
+
+        std::vector<int> done(cpus.size(), 0);
+        {
+            ThreadGroup group;
+            group.spawnPinned(cpus, "worker", [&done](std::stop_token token, size_t i) {
+                {
+                    std::lock_guard<std::mutex> lock(jobs_mutex);
+                    std::cout << "worker " << i << " runs on CPU " << sched_getcpu() << "\n";
+                }
+                worker(token, i, done);
+            });
+
+            for (int j = 0; j < numJobs; ++j) {
+                {
+                    std::lock_guard<std::mutex> lock(jobs_mutex);
+                    jobs.push_back(j);
+                }
+                jobs_cv.notify_one();
+            }
+            while (true) { // wait for the queue to drain
+                {
+                    std::lock_guard<std::mutex> lock(jobs_mutex);
+                    if (jobs.empty()) {
+                        break;
+                    }
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            bool stopped = group.joinFor(std::chrono::milliseconds(500));
+            double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+            std::cout << "stopped " << cpus.size() << " workers: " << std::boolalpha << stopped << " in " << us << " us\n";
+            for (size_t i = 0; i < done.size(); ++i) {
+                std::cout << "worker " << i << " did " << done[i] << " jobs\n";
+            }
+        }
+
+        {
+            ThreadGroup group;
+            group.spawn({"stubborn", {}}, [](std::stop_token) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(300)); // never looks at the token
+            });
+            bool stopped = group.joinFor(std::chrono::milliseconds(50));
+            std::cout << "stubborn worker stopped within 50 ms: " << stopped << ", still running: " << group.running() << "\n";
+            stopped = group.joinFor(std::chrono::seconds(1));
+            std::cout << "stopped within another second: " << stopped << "\n";
+        }
+
+        try {
+            ThreadGroup group;
+            group.spawn({"nowhere", {CPU_SETSIZE - 1}}, [](std::stop_token) {});
+        } catch (const std::system_error& e) {
+            std::cout << "spawn failed: " << e.what() << "\n";
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,147 @@
+// NUMA-aware placement of the task-queue workers of 0x19-packaged_task_real_example.cpp (numaTopology.hpp)
+// 1. the topology: NUMA nodes and their CPUs, from /sys/devices/system/node (or a simulated split).
+// 2. the remote access penalty: a buffer is first touched (so placed) by a CPU of node B, then a CPU of node A
+//    walks it in random order; ns per access for every (A, B) pair.
+// 3. throughput: every node owns data chunks (placed on it by first touch); a task sums one chunk.
+//    * NUMA-aware: per-node queues, workers pinned per core, tasks posted to the node that owns the chunk;
+//    * like 0x19: one shared queue, unpinned workers.
+// On a single-node box pass a number of nodes to simulate: the placement code runs the same way, but the
+// memory is not really remote, so expect no penalty.
+// usage: ./a.out [simulated_nodes (0: real topology)] [chunks_per_node] [rounds]
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <random>
+#include <numeric>
+#include <chrono>
+#include <string>
+#include <memory>
+#include "numaTopology.hpp"
+#include "syncPrimitives.hpp"
+
+const size_t chunkWords = 256 * 1024 / sizeof(uint64_t); // 256KB per chunk
+
+// runs fn on a thread pinned to `cpu` and waits for it
+template <typename Fn>
+void onCpu(int cpu, Fn fn) {
+    std::thread t([cpu, &fn] {
+        pinCurrentThread({cpu});
+        fn();
+    });
+    t.join();
+}
+
+// ns per dependent load in a random cycle over `bytes` placed by `placeCpu` and read by `readCpu`
+double chaseNs(int placeCpu, int readCpu, size_t bytes) {
+    const size_t stride = 64 / sizeof(size_t); // one element per cache line
+    size_t lines = bytes / 64;
+    std::unique_ptr<std::vector<size_t>> next;
+    onCpu(placeCpu, [&] {
+        next = std::make_unique<std::vector<size_t>>(lines * stride); // first touch: the pages land on placeCpu's node
+        std::vector<size_t> order(lines);
+        std::iota(order.begin(), order.end(), 0);
+        std::shuffle(order.begin() + 1, order.end(), std::mt19937_64(7));
+        for (size_t i = 0; i < lines; ++i) {
+            (*next)[order[i] * stride] = order[(i + 1) % lines] * stride;
+        }
+    });
+    double ns = 0;
+    onCpu(readCpu, [&] {
+        const size_t steps = 4'000'000;
+        size_t p = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < steps; ++i) {
+            p = (*next)[p];
+        }
+        ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / steps;
+        if (p == size_t(-1)) {
+            std::cout << ""; // keeps p alive
+        }
+    });
+    return ns;
+}
+
+struct Chunk {
+    size_t node;
+    std::vector<uint64_t> data;
+};
+
+double runThroughput(const std::string& name, NumaTaskPool& pool, const std::vector<std::unique_ptr<Chunk>>& chunks,
+                     int rounds, bool postToOwner) {
+    std::atomic<uint64_t> total{0};
+    Latch done(static_cast<std::ptrdiff_t>(chunks.size()) * rounds);
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (const auto& c : chunks) {
+            const Chunk* chunk = c.get();
+            pool.post(postToOwner ? chunk->node : 0, [chunk, &total, &done] {
+                total.fetch_add(std::accumulate(chunk->data.begin(), chunk->data.end(), uint64_t(0)),
+                                std::memory_order_relaxed);
+                done.count_down();
+            });
+        }
+    }
+    done.wait();
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double tasks = static_cast<double>(chunks.size()) * rounds;
+    std::cout << name << ": " << tasks / s << " tasks/s, " << tasks * chunkWords * 8 / s / 1e9 << " GB/s ("
+              << pool.localRuns() << " local, " << pool.stolenRuns() << " stolen, checksum " << total << ")\n";
+    return s;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        int simulate = argc > 1 ? std::stoi(argv[1]) : 0;
+        size_t chunksPerNode = argc > 2 ? std::stoul(argv[2]) : 64;
+        int rounds = argc > 3 ? std::stoi(argv[3]) : 20;
+
+        Topology topo = simulate > 0 ? Topology::simulated(simulate) : Topology::discover();
+        std::cout << topo.nodeCount() << " node(s)" << (topo.isSimulated() ? " (simulated)" : "") << ":\n";
+        for (size_t n = 0; n < topo.nodeCount(); ++n) {
+            const NumaNode& node = topo.nodes()[n];
+            std::cout << "  node " << node.id << ": CPUs";
+            for (int c : node.cpus) {
+                std::cout << " " << c;
+            }
+            std::cout << ", distances";
+            for (size_t to = 0; to < topo.nodeCount(); ++to) {
+                std::cout << " " << topo.distance(n, to);
+            }
+            std::cout << "\n";
+        }
+        if (topo.nodeCount() == 1 && simulate == 0) {
+            std::cout << "(single node: run with e.g. `./a.out 2` to exercise the per-node queues)\n";
+        }
+
+        std::cout << "random access over 64MB, ns per access (row: reading node, column: memory node)\n";
+        for (const auto& reader : topo.nodes()) {
+            std::cout << "  node " << reader.id << ":";
+            for (const auto& owner : topo.nodes()) {
+                std::cout << " " << chaseNs(owner.cpus.front(), reader.cpus.front(), 64u << 20);
+            }
+            std::cout << "\n";
+        }
+
+        // the data of every node is created by a thread running on that node
+        std::vector<std::unique_ptr<Chunk>> chunks;
+        for (size_t n = 0; n < topo.nodeCount(); ++n) {
+            onCpu(topo.nodes()[n].cpus.front(), [&] {
+                for (size_t i = 0; i < chunksPerNode; ++i) {
+                    chunks.push_back(std::make_unique<Chunk>(Chunk{n, std::vector<uint64_t>(chunkWords, n + 1)}));
+                }
+            });
+        }
+        {
+            NumaTaskPool pool(topo, NumaTaskPool::Placement::pinPerCore);
+            runThroughput("per-node queues, pinned per core", pool, chunks, rounds, true);
+        }
+        {
+            NumaTaskPool pool(Topology::flat(), NumaTaskPool::Placement::unpinned);
+            runThroughput("one queue, unpinned (like 0x19)  ", pool, chunks, rounds, false);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,191 @@
+// Priority classes, earliest deadline first and aging (deadlineScheduler.hpp) against the FIFO task_q of
+// 0x18/0x19.
+// Mixed workload on the same number of workers:
+// * batch: a burst of slow queries (`batch_ms` each) submitted at once, no deadline;
+// * interactive: short queries (1 ms) arriving every 5 ms, each with a 100 ms deadline.
+// With the FIFO queue an interactive query waits behind the whole batch backlog. With the scheduler it waits at
+// most for a worker to finish its current batch query; aging still gives the old batch queries a share of the
+// workers, and an interactive query that can not make its deadline any more is dropped instead of run late.
+// Latency = submit to completion, p50/p99 per class. With a single worker and slower batch queries
+// (./a.out 50 300 1 150) an interactive query can wait longer than its deadline and gets dropped.
+// usage: ./a.out [batch_queries] [interactive_queries] [workers] [batch_ms]
+#include <iostream>
+#include <thread>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include "deadlineScheduler.hpp"
+
+using Clock = std::chrono::steady_clock;
+using std::chrono::milliseconds;
+
+constexpr auto interactiveWork = milliseconds(1);
+constexpr auto interactiveGap = milliseconds(5);
+constexpr auto interactiveDeadline = milliseconds(100);
+
+struct Workload {
+    int batch;
+    int interactive;
+    int workers;
+    milliseconds batchWork;
+};
+
+// latency of every query of a class (ms), -1 for a dropped one
+struct Latencies {
+    std::vector<double> batch;
+    std::vector<double> interactive;
+};
+
+double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void report(const std::string& name, std::vector<double> ms, bool hasDeadline) {
+    size_t dropped = std::count(ms.begin(), ms.end(), -1.0);
+    ms.erase(std::remove(ms.begin(), ms.end(), -1.0), ms.end());
+    std::sort(ms.begin(), ms.end());
+    size_t late = ms.end() - std::upper_bound(ms.begin(), ms.end(), static_cast<double>(interactiveDeadline.count()));
+    std::cout << "  " << name << ": ";
+    if (ms.empty()) {
+        std::cout << "none completed";
+    } else {
+        std::cout << "p50 " << ms[ms.size() / 2] << " ms, p99 " << ms[std::min(ms.size() - 1, ms.size() * 99 / 100)]
+                  << " ms, max " << ms.back() << " ms";
+    }
+    std::cout << " (" << ms.size() << " done";
+    if (hasDeadline) {
+        std::cout << ", " << late << " after the deadline, " << dropped << " dropped";
+    }
+    std::cout << ")\n";
+}
+
+// the task queue of 0x18-packaged_task.cpp
+class FifoQueue {
+private:
+    std::deque<std::packaged_task<void()>> task_q;
+    std::mutex task_q_mutex;
+    std::condition_variable_any task_q_cv;
+    ThreadGroup workers; // last: joined before the queue is destroyed
+
+public:
+    explicit FifoQueue(int threads) {
+        for (int i = 0; i < threads; ++i) {
+            workers.spawn({"fifo-" + std::to_string(i), {}}, [this](std::stop_token token) {
+                while (true) {
+                    std::packaged_task<void()> task;
+                    {
+                        std::unique_lock<std::mutex> lock(task_q_mutex);
+                        if (!task_q_cv.wait(lock, token, [this] { return !task_q.empty(); })) {
+                            return;
+                        }
+                        task = std::move(task_q.front());
+                        task_q.pop_front();
+                    }
+                    task();
+                }
+            });
+        }
+    }
+
+    template <typename Fn>
+    std::future<void> submit(Fn fn) {
+        std::packaged_task<void()> task(std::move(fn));
+        std::future<void> result = task.get_future();
+        {
+            std::lock_guard<std::mutex> lock(task_q_mutex);
+            task_q.push_back(std::move(task));
+        }
+        task_q_cv.notify_one();
+        return result;
+    }
+};
+
+// runs the workload; submit(isInteractive, fn) queues one query and returns its future
+template <typename Submit>
+Latencies runWorkload(const Workload& w, Submit submit) {
+    Latencies lat{std::vector<double>(w.batch), std::vector<double>(w.interactive)};
+    std::vector<std::future<void>> batch, interactive;
+
+    for (int i = 0; i < w.batch; ++i) {
+        auto submitted = Clock::now();
+        batch.push_back(submit(false, [&lat, i, submitted, work = w.batchWork] {
+            std::this_thread::sleep_for(work);
+            lat.batch[i] = msSince(submitted); // each task writes its own slot; read after its future is ready
+        }));
+    }
+    auto next = Clock::now();
+    for (int i = 0; i < w.interactive; ++i) {
+        std::this_thread::sleep_until(next);
+        next += interactiveGap;
+        auto submitted = Clock::now();
+        interactive.push_back(submit(true, [&lat, i, submitted] {
+            std::this_thread::sleep_for(interactiveWork);
+            lat.interactive[i] = msSince(submitted);
+        }));
+    }
+
+    for (auto& f : batch) {
+        f.get();
+    }
+    for (int i = 0; i < w.interactive; ++i) {
+        try {
+            interactive[i].get();
+        } catch (const DeadlineExpired&) {
+            lat.interactive[i] = -1;
+        }
+    }
+    return lat;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        Workload w{argc > 1 ? std::stoi(argv[1]) : 100, argc > 2 ? std::stoi(argv[2]) : 300,
+                   argc > 3 ? std::stoi(argv[3]) : 2, milliseconds(argc > 4 ? std::stoi(argv[4]) : 20)};
+        std::cout << w.batch << " batch queries (" << w.batchWork.count() << " ms) + " << w.interactive
+                  << " interactive queries (1 ms, every 5 ms, 100 ms deadline) on " << w.workers << " workers\n";
+
+        Latencies fifo;
+        {
+            FifoQueue q(w.workers);
+            fifo = runWorkload(w, [&q](bool, auto fn) { return q.submit(std::move(fn)); });
+        }
+        std::cout << "FIFO task_q:\n";
+        report("interactive", fifo.interactive, true);
+        report("batch      ", fifo.batch, false);
+
+        Latencies sched;
+        {
+            // class 0: interactive, class 1: batch; a batch query older than 500 ms gets one pick in four
+            DeadlineScheduler s(2, w.workers, milliseconds(500), 4);
+            sched = runWorkload(w, [&s](bool isInteractive, auto fn) {
+                if (isInteractive) {
+                    return s.submit(0, Clock::now() + interactiveDeadline, std::move(fn));
+                }
+                return s.submit(1, std::move(fn));
+            });
+            DeadlineScheduler::ClassStats interactiveStats = s.stats(0);
+            DeadlineScheduler::ClassStats batchStats = s.stats(1);
+            std::cout << "DeadlineScheduler (priority classes + EDF + aging):\n";
+            report("interactive", sched.interactive, true);
+            report("batch      ", sched.batch, false);
+            std::cout << "  batch queries run early by aging: " << batchStats.aged
+                      << ", interactive dropped in the queue: " << interactiveStats.dropped << "\n";
+
+            // a deadline that has already passed is rejected at submit
+            try {
+                s.submit(0, Clock::now() - milliseconds(1), [] {});
+            } catch (const DeadlineExpired& e) {
+                std::cout << "submit with a past deadline: " << e.what() << "\n";
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,171 @@
+// Allocation-free task submission: UniqueFunction (uniqueFunction.hpp) + PooledPromise (pooledPromise.hpp)
+// Every enqueue in 0x18/0x19 builds `std::packaged_task<int()>(std::bind(factorial, 4))`: the packaged_task
+// allocates its shared state (the bound callable lives in it) and, in libstdc++, a separate slot for the result.
+// Here the same submit/run/get round trip is done three ways, through the same fixed-size ring queue (so the
+// queue itself never allocates) and one worker thread:
+// 1. std::packaged_task + std::bind, as in 0x18;
+// 2. UniqueFunction<void(), 48> holding a small lambda (argument + std::promise): the lambda is stored inline,
+//    but std::promise still allocates its shared state and result slot;
+// 3. UniqueFunction + PooledPromise: the shared state comes from a SharedStatePool, so after warm-up a
+//    submission does not allocate at all.
+// Every operator new is counted; the result is reported as allocations and submissions per second.
+// The corner cases (inline or heap storage, an empty call, a broken promise, ...) and the allocation-free
+// submission are checked in tests/test_concurrency.cpp.
+// usage: ./a.out [number_of_submissions] [window]
+#include <iostream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <functional>
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <string>
+#include <cstdlib>
+#include <new>
+#include "uniqueFunction.hpp"
+#include "pooledPromise.hpp"
+
+std::atomic<long> allocations{0};
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+int factorial(int n) {
+    int result = 1;
+    for (int i = 1; i <= n; ++i) {
+        result *= i;
+    }
+    return result;
+}
+
+// task_q of 0x18 with a fixed capacity: the slots are allocated once, push/pop only move tasks in and out
+template <typename T>
+class RingQueue {
+private:
+    std::vector<T> slots_;
+    size_t head_ = 0, size_ = 0;
+    bool closed_ = false;
+    std::mutex mtx_;
+    std::condition_variable notEmpty_, notFull_;
+
+public:
+    explicit RingQueue(size_t capacity) : slots_(capacity) {}
+
+    void push(T t) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        notFull_.wait(lock, [this] { return size_ < slots_.size(); });
+        slots_[(head_ + size_++) % slots_.size()] = std::move(t);
+        lock.unlock();
+        notEmpty_.notify_one();
+    }
+
+    // false once the queue is closed and empty
+    bool pop(T& out) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        notEmpty_.wait(lock, [this] { return closed_ || size_ > 0; });
+        if (size_ == 0) {
+            return false;
+        }
+        out = std::move(slots_[head_]);
+        head_ = (head_ + 1) % slots_.size();
+        --size_;
+        lock.unlock();
+        notFull_.notify_one();
+        return true;
+    }
+
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            closed_ = true;
+        }
+        notEmpty_.notify_all();
+    }
+};
+
+// submits `n` tasks in windows of `window` (submit a window, then get its results); makeTask(i) returns
+// {task, future}
+template <typename TaskT, typename MakeTask>
+void benchmark(const std::string& name, long n, size_t window, MakeTask makeTask) {
+    RingQueue<TaskT> q(window);
+    std::thread worker([&q] {
+        TaskT t;
+        while (q.pop(t)) {
+            t();
+        }
+    });
+
+    using Fut = decltype(makeTask(0).second);
+    std::vector<Fut> futures;
+    futures.reserve(window);
+    long sum = 0;
+    auto round = [&](long count) {
+        for (long i = 0; i < count; i += static_cast<long>(window)) {
+            for (size_t j = 0; j < window && i + static_cast<long>(j) < count; ++j) {
+                auto [task, future] = makeTask(static_cast<int>((i + j) % 12 + 1));
+                futures.push_back(std::move(future));
+                q.push(std::move(task));
+            }
+            for (auto& f : futures) {
+                sum += f.get();
+            }
+            futures.clear();
+        }
+    };
+
+    round(static_cast<long>(window) * 4); // warm-up: pools and queue slots
+    long before = allocations.load();
+    auto start = std::chrono::steady_clock::now();
+    round(n);
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    long allocs = allocations.load() - before;
+
+    q.close();
+    worker.join();
+    std::cout << name << ": " << static_cast<long>(n / sec) << " submissions/s, "
+              << static_cast<double>(allocs) / n << " allocations per submission (checksum " << sum << ")\n";
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        long n = argc > 1 ? std::stol(argv[1]) : 200'000;
+        size_t window = argc > 2 ? std::stoul(argv[2]) : 64;
+        std::cout << n << " submissions, " << window << " in flight\n";
+
+        benchmark<std::packaged_task<int()>>("packaged_task + bind          ", n, window, [](int k) {
+            std::packaged_task<int()> t(std::bind(factorial, k));
+            std::future<int> f = t.get_future();
+            return std::make_pair(std::move(t), std::move(f));
+        });
+
+        using Fn = UniqueFunction<void(), 48>;
+        benchmark<Fn>("UniqueFunction + std::promise ", n, window, [](int k) {
+            std::promise<int> p;
+            std::future<int> f = p.get_future();
+            Fn t([k, p = std::move(p)]() mutable { p.set_value(factorial(k)); });
+            return std::make_pair(std::move(t), std::move(f));
+        });
+
+        SharedStatePool<int> pool;
+        benchmark<Fn>("UniqueFunction + PooledPromise", n, window, [&pool](int k) {
+            PooledPromise<int> p(pool);
+            PooledFuture<int> f = p.get_future();
+            Fn t([k, p = std::move(p)]() mutable { p.set_value(factorial(k)); });
+            return std::make_pair(std::move(t), std::move(f));
+        });
+        std::cout << "pooled shared states allocated: " << pool.capacity() << "\n";
+    } catch (const std::exception& e) {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
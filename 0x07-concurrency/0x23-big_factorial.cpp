@@ -0,0 +1,79 @@
+// Arbitrary-precision factorial (bigUint.hpp)
+// The futures and packaged_task examples compute factorial(n) in an int, which is wrong from 13! on. BigUint
+// gives the real value, and computing a large n! is a CPU-bound job worth spreading over threads:
+// 1. the same std::async / std::packaged_task call sites as 0x14 and 0x18, with bigFactorial instead of the
+//    int factorial;
+// 2. scaling: n! for n = 10^4, 10^5, 10^6 with schoolbook multiplication, with Karatsuba, and with the product
+//    tree spread over a ThreadPool (schoolbook is skipped above 10^5: it is quadratic).
+// Exits with 1 if the algorithms disagree (or 30! is wrong), so race_check.sh catches a wrong product too.
+// usage: ./a.out [max_n] [threads]
+#include <iostream>
+#include <future>
+#include <thread>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "bigUint.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+int factorial(int n) { // the one of the examples
+    int res = 1;
+    for (int i = 1; i <= n; i++) {
+        res *= i;
+    }
+    return res;
+}
+
+template <typename Fn>
+BigUint timed(const std::string& name, Fn fn) {
+    auto start = Clock::now();
+    BigUint r = fn();
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    std::cout << "  " << name << ": " << ms << " ms\n";
+    return r;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        uint32_t maxN = argc > 1 ? static_cast<uint32_t>(std::stoul(argv[1])) : 1'000'000;
+        size_t threads = argc > 2 ? std::stoul(argv[2]) : std::max(2u, std::thread::hardware_concurrency());
+
+        std::cout << "int factorial(13) = " << factorial(13) << " (overflowed)\n";
+        std::future<BigUint> fut = std::async(std::launch::async, bigFactorial, 13, MulAlgorithm::karatsuba);
+        std::cout << "bigFactorial(13)  = " << fut.get().toString() << "\n";
+
+        std::packaged_task<BigUint()> t([] { return bigFactorial(30); });
+        std::future<BigUint> f = t.get_future();
+        std::thread(std::move(t)).join();
+        std::string s30 = f.get().toString();
+        bool ok = s30 == "265252859812191058636308480000000";
+        std::cout << "30! = " << s30 << (ok ? " (correct)" : " (WRONG)") << "\n";
+
+        ThreadPool pool(threads);
+        std::cout << "scaling, " << threads << " pool threads on " << std::thread::hardware_concurrency() << " CPUs:\n";
+        for (uint32_t n = 10'000; n <= maxN; n *= 10) {
+            std::cout << "n = " << n << "\n";
+            BigUint school;
+            if (n <= 100'000) {
+                school = timed("schoolbook, 1 thread ", [n] { return bigFactorial(n, MulAlgorithm::schoolbook); });
+            }
+            BigUint kara = timed("Karatsuba, 1 thread  ", [n] { return bigFactorial(n); });
+            BigUint par = timed("Karatsuba, pool      ", [n, &pool] { return parallelFactorial(n, pool); });
+            bool same = par == kara && (n > 100'000 || school == kara);
+            std::cout << "  " << kara.bitLength() << " bits, results " << (same ? "match" : "DIFFER") << "\n";
+            ok = ok && same;
+            if (n == 10'000) {
+                std::cout << "  " << kara.toString().size() << " decimal digits\n"; // 35660
+            }
+        }
+        if (!ok) {
+            std::cerr << "wrong result" << std::endl;
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,261 @@
+// Stress and scalability benchmarks for the concurrency primitives of the examples (benchSuite.hpp)
+// Each benchmark is the pattern of an example, run by 1..8 threads with a payload of a few sizes. ns/op is the
+// wall time divided by the operations of all threads (items moved through the buffer, round trips):
+// * LogFile/shared_print: the mutex-protected LogFile of 0x0B-thread_mutex.cpp (logFile.hpp), every thread writes lines of
+//   `payload` characters (with std::endl, as in the example: a write() per line);
+// * cv_buffer/producer_consumer: the deque + condition_variable buffer of 0x13-condition_variables.cpp, half the
+//   threads push items of `payload` bytes and the other half pop them;
+// * packaged_task_queue/submit_get: the task_q of 0x18-packaged_task.cpp with as many workers as submitters;
+//   every submitter queues a packaged_task (capturing `payload` bytes) and waits for its future;
+// * future_promise/round_trip: pairs of threads, one sends a promise, the other fulfils it with `payload` bytes;
+// * shared_ptr/copy_shared, shared_ptr/copy_private: copying a shared_ptr that all threads share (one
+//   reference count, the cache line bounces between the cores) and one per thread (no sharing);
+// * counter/atomic_fetch_add, counter/mutex: the shared counter of
+//   smart_pointers_with_multithreading/0x01-muti_threading.cpp, with a std::atomic and with a mutex.
+// usage: ./a.out [--filter=<substring>] [--min_time=0.1] [--repetitions=3] [--threads=1,2,4] [--payloads=16,256]
+//                [--json=results.json] [--context=commit=<hash>]
+#include <iostream>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <atomic>
+#include <string>
+#include <vector>
+#include "benchSuite.hpp"
+#include "logFile.hpp"
+
+// 0x13-condition_variables.cpp, with a producerDone() so the consumers know when to stop
+class CvBuffer {
+private:
+    std::deque<std::vector<char>> buffer;
+    std::mutex mtx;
+    std::condition_variable condition_var;
+    size_t producersLeft;
+
+public:
+    explicit CvBuffer(size_t producers) : producersLeft(producers) {}
+
+    void push(std::vector<char> item) {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            buffer.push_front(std::move(item));
+        }
+        condition_var.notify_one();
+    }
+
+    void producerDone() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            --producersLeft;
+        }
+        condition_var.notify_all();
+    }
+
+    // false when every producer is done and the buffer is empty
+    bool pop(std::vector<char>& out) {
+        std::unique_lock<std::mutex> lock(mtx);
+        condition_var.wait(lock, [this] { return !buffer.empty() || producersLeft == 0; });
+        if (buffer.empty()) {
+            return false;
+        }
+        out = std::move(buffer.back());
+        buffer.pop_back();
+        return true;
+    }
+};
+
+// 0x18-packaged_task.cpp, with `workers` threads running the queued tasks
+class TaskQueue {
+private:
+    std::deque<std::packaged_task<size_t()>> task_q;
+    std::mutex task_q_mutex;
+    std::condition_variable task_q_cv;
+    bool stopping = false;
+    std::vector<std::thread> workers;
+
+public:
+    explicit TaskQueue(size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            workers.emplace_back([this] {
+                while (true) {
+                    std::packaged_task<size_t()> t;
+                    {
+                        std::unique_lock<std::mutex> lock(task_q_mutex);
+                        task_q_cv.wait(lock, [this] { return stopping || !task_q.empty(); });
+                        if (task_q.empty()) {
+                            return;
+                        }
+                        t = std::move(task_q.front());
+                        task_q.pop_front();
+                    }
+                    t();
+                }
+            });
+        }
+    }
+
+    ~TaskQueue() {
+        {
+            std::lock_guard<std::mutex> lock(task_q_mutex);
+            stopping = true;
+        }
+        task_q_cv.notify_all();
+        for (auto& w : workers) {
+            w.join();
+        }
+    }
+
+    std::future<size_t> submit(std::packaged_task<size_t()> t) {
+        std::future<size_t> f = t.get_future();
+        {
+            std::lock_guard<std::mutex> lock(task_q_mutex);
+            task_q.push_back(std::move(t));
+        }
+        task_q_cv.notify_one();
+        return f;
+    }
+};
+
+// one requester and one responder: the requester sends a promise, the responder keeps it
+struct Mailbox {
+    std::deque<std::promise<std::string>> requests;
+    std::mutex mtx;
+    std::condition_variable cv;
+};
+
+int main(int argc, char* argv[]) {
+    try {
+        bench::Suite suite;
+        suite.parseArgs(argc, argv);
+
+        suite.add("LogFile/shared_print", [](bench::Run& run) {
+            LogFile log("/tmp/bench_suite_log.txt");
+            std::string message(run.payload(), 'x');
+            run.parallel([&](size_t t, size_t iterations) {
+                for (size_t i = 0; i < iterations; ++i) {
+                    log.shared_print(message, static_cast<int>(t));
+                }
+            });
+        }).payload({16, 256});
+
+        suite.add("cv_buffer/producer_consumer", [](bench::Run& run) {
+            size_t producers = std::max<size_t>(1, run.threads() / 2);
+            CvBuffer buffer(producers);
+            run.setItemsProcessed(producers * run.iterations());
+            run.parallel([&](size_t t, size_t iterations) {
+                if (t % 2 == 0 && t / 2 < producers) {
+                    for (size_t i = 0; i < iterations; ++i) {
+                        buffer.push(std::vector<char>(run.payload(), 'x'));
+                    }
+                    buffer.producerDone();
+                } else {
+                    std::vector<char> item;
+                    size_t bytes = 0;
+                    while (buffer.pop(item)) {
+                        bytes += item.size();
+                    }
+                    bench::doNotOptimize(bytes);
+                }
+            });
+        }).threads({2, 4, 8}).payload({16, 1024}).minThreads(2);
+
+        suite.add("packaged_task_queue/submit_get", [](bench::Run& run) {
+            TaskQueue q(run.threads());
+            run.parallel([&](size_t, size_t iterations) {
+                for (size_t i = 0; i < iterations; ++i) {
+                    std::packaged_task<size_t()> t([data = std::vector<char>(run.payload(), 'x')] { return data.size(); });
+                    bench::doNotOptimize(q.submit(std::move(t)).get());
+                }
+            });
+        }).payload({16, 1024});
+
+        suite.add("future_promise/round_trip", [](bench::Run& run) {
+            std::vector<Mailbox> boxes(run.threads() / 2);
+            run.setItemsProcessed(boxes.size() * run.iterations());
+            run.parallel([&](size_t t, size_t iterations) {
+                if (t / 2 >= boxes.size()) {
+                    return; // odd thread count: the last thread has no partner
+                }
+                Mailbox& box = boxes[t / 2];
+                if (t % 2 == 0) {
+                    for (size_t i = 0; i < iterations; ++i) {
+                        std::promise<std::string> p;
+                        std::future<std::string> f = p.get_future();
+                        {
+                            std::lock_guard<std::mutex> lock(box.mtx);
+                            box.requests.push_back(std::move(p));
+                        }
+                        box.cv.notify_one();
+                        bench::doNotOptimize(f.get().size());
+                    }
+                } else {
+                    for (size_t i = 0; i < iterations; ++i) {
+                        std::promise<std::string> p;
+                        {
+                            std::unique_lock<std::mutex> lock(box.mtx);
+                            box.cv.wait(lock, [&box] { return !box.requests.empty(); });
+                            p = std::move(box.requests.front());
+                            box.requests.pop_front();
+                        }
+                        p.set_value(std::string(run.payload(), 'x'));
+                    }
+                }
+            });
+        }).threads({2, 4, 8}).payload({16, 1024}).minThreads(2);
+
+        suite.add("shared_ptr/copy_shared", [](bench::Run& run) {
+            auto shared = std::make_shared<std::vector<char>>(run.payload());
+            run.parallel([&](size_t, size_t iterations) {
+                for (size_t i = 0; i < iterations; ++i) {
+                    std::shared_ptr<std::vector<char>> copy = shared;
+                    bench::doNotOptimize(copy);
+                }
+            });
+        }).payload({64});
+
+        suite.add("shared_ptr/copy_private", [](bench::Run& run) {
+            std::vector<std::shared_ptr<std::vector<char>>> own;
+            for (size_t t = 0; t < run.threads(); ++t) {
+                own.push_back(std::make_shared<std::vector<char>>(run.payload()));
+            }
+            run.parallel([&](size_t t, size_t iterations) {
+                for (size_t i = 0; i < iterations; ++i) {
+                    std::shared_ptr<std::vector<char>> copy = own[t];
+                    bench::doNotOptimize(copy);
+                }
+            });
+        }).payload({64});
+
+        suite.add("counter/atomic_fetch_add", [](bench::Run& run) {
+            std::atomic<long> counter{0};
+            run.parallel([&](size_t, size_t iterations) {
+                for (size_t i = 0; i < iterations; ++i) {
+                    counter.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+            bench::doNotOptimize(counter.load());
+        });
+
+        suite.add("counter/mutex", [](bench::Run& run) {
+            std::mutex mtx;
+            long counter = 0;
+            run.parallel([&](size_t, size_t iterations) {
+                for (size_t i = 0; i < iterations; ++i) {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    ++counter;
+                }
+            });
+            bench::doNotOptimize(counter);
+        });
+
+        suite.runAll();
+    } catch (const std::exception& e) {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,338 @@
+#ifndef BENCH_SUITE_HPP
+#define BENCH_SUITE_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+#include "syncPrimitives.hpp"
+
+// A small header-only benchmark runner in the spirit of Google Benchmark, for the concurrency examples.
+// * a benchmark is a function that builds its shared objects (a LogFile, a queue, ...) and then calls
+//   run.parallel(fn): fn(threadIndex, iterations) runs on run.threads() threads that start together, and only
+//   that part is timed;
+// * every benchmark runs for each combination of its thread counts and payload sizes ("Name/threads:4/payload:64");
+//   one that pairs threads up (a producer and a consumer, ...) sets minThreads(2), and the smaller thread counts
+//   (from --threads=) are skipped;
+// * the iteration count is calibrated until a run lasts at least `minTime`, then the run is repeated and the
+//   median is reported (with min and max, to see the noise), along with the CPU time of the process over the
+//   same run (all threads together: above the wall time when the threads really run in parallel, below it when
+//   they wait);
+// * the results go to the console and, with --json=<file>, to a JSON file with the same layout as Google
+//   Benchmark's (context + benchmarks[] with real_time and cpu_time), so existing comparison scripts
+//   (tools/compare.py of Google Benchmark) can diff two commits.
+// Options: --filter=<substring> --min_time=<seconds> --repetitions=<n> --threads=1,2,4 --payloads=16,256
+//          --json=<file> --context=<key>=<value> (repeatable, e.g. --context=commit=$(git rev-parse HEAD))
+
+namespace bench {
+
+struct Result {
+    std::string name;
+    std::string benchmark;
+    size_t threads;
+    size_t payload;
+    size_t iterations; // per thread
+    double nsPerOp;    // median over the repetitions; an op is one iteration of one thread, or one item
+    double minNsPerOp;
+    double maxNsPerOp;
+    double cpuNsPerOp; // median over the repetitions, process CPU time
+    double itemsPerSecond;
+};
+
+class Run {
+private:
+    size_t threads_;
+    size_t payload_;
+    size_t iterations_;
+    size_t items_ = 0;
+    bool itemsSet_ = false;
+    double seconds_ = -1;
+    double cpuSeconds_ = -1;
+
+    static double processCpuSeconds() {
+        timespec ts;
+        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+        return static_cast<double>(ts.tv_sec) + ts.tv_nsec * 1e-9;
+    }
+
+public:
+    Run(size_t threads, size_t payload, size_t iterations)
+        : threads_(threads), payload_(payload), iterations_(iterations) {}
+
+    size_t threads() const { return threads_; }
+    size_t payload() const { return payload_; }
+    size_t iterations() const { return iterations_; }
+    double seconds() const { return seconds_; }
+    double cpuSeconds() const { return cpuSeconds_; }
+    size_t items() const { return itemsSet_ ? items_ : threads_ * iterations_; }
+
+    // when not every thread does `iterations` ops (e.g. half of them only consume), the number of items processed
+    void setItemsProcessed(size_t items) {
+        items_ = items;
+        itemsSet_ = true;
+    }
+
+    // runs fn(threadIndex, iterations) on threads() threads and times it, from the moment they all start to
+    // the moment the last one is done: wall time, and the CPU time of the whole process over that span
+    template <typename Fn>
+    void parallel(Fn fn) {
+        Latch ready(static_cast<std::ptrdiff_t>(threads_));
+        Latch go(1);
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads_; ++t) {
+            workers.emplace_back([&, t] {
+                ready.count_down();
+                go.wait();
+                fn(t, iterations_);
+            });
+        }
+        ready.wait();
+        double cpuStart = processCpuSeconds();
+        auto start = std::chrono::steady_clock::now();
+        go.count_down();
+        for (auto& w : workers) {
+            w.join();
+        }
+        seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        cpuSeconds_ = processCpuSeconds() - cpuStart;
+    }
+};
+
+struct Benchmark {
+    std::string name;
+    std::function<void(Run&)> fn;
+    std::vector<size_t> threadCounts{1, 2, 4, 8};
+    std::vector<size_t> payloads{0};
+    size_t minThreadCount = 1;
+
+    Benchmark& threads(std::vector<size_t> t) {
+        threadCounts = std::move(t);
+        return *this;
+    }
+    Benchmark& payload(std::vector<size_t> p) {
+        payloads = std::move(p);
+        return *this;
+    }
+    // the fewest threads the benchmark makes sense with
+    Benchmark& minThreads(size_t n) {
+        minThreadCount = n;
+        return *this;
+    }
+};
+
+inline std::string jsonEscape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            std::ostringstream hex;
+            hex << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c);
+            out += hex.str();
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+inline std::vector<size_t> parseList(const std::string& s) {
+    std::vector<size_t> values;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        values.push_back(std::stoul(item));
+    }
+    return values;
+}
+
+class Suite {
+private:
+    std::vector<Benchmark> benchmarks_;
+    std::string filter_;
+    double minTime_ = 0.1;
+    int repetitions_ = 3;
+    std::vector<size_t> threadsOverride_, payloadsOverride_;
+    std::string jsonPath_;
+    std::vector<std::pair<std::string, std::string>> context_;
+
+    // one timed run with `iterations` per thread: {seconds, cpu seconds, items}
+    static std::tuple<double, double, double> timeOnce(const Benchmark& b, size_t threads, size_t payload,
+                                                       size_t iterations) {
+        Run run(threads, payload, iterations);
+        b.fn(run);
+        if (run.seconds() < 0) {
+            throw std::logic_error("benchmark " + b.name + " did not call Run::parallel");
+        }
+        if (run.items() == 0) {
+            throw std::logic_error("benchmark " + b.name + " processed no items with " + std::to_string(threads) +
+                                   " threads");
+        }
+        return {run.seconds(), run.cpuSeconds(), static_cast<double>(run.items())};
+    }
+
+    Result measure(const Benchmark& b, size_t threads, size_t payload) const {
+        // calibration: grow the iteration count until one run takes at least minTime
+        size_t iterations = 1;
+        auto [seconds, cpuSeconds, items] = timeOnce(b, threads, payload, iterations);
+        while (seconds < minTime_ && iterations < (size_t(1) << 40)) {
+            double factor = seconds > 0 ? std::min(10.0, std::max(1.5, 1.4 * minTime_ / seconds)) : 10.0;
+            iterations = static_cast<size_t>(iterations * factor) + 1;
+            std::tie(seconds, cpuSeconds, items) = timeOnce(b, threads, payload, iterations);
+        }
+        std::vector<double> ns, cpuNs;
+        ns.push_back(seconds * 1e9 / items);
+        cpuNs.push_back(cpuSeconds * 1e9 / items);
+        for (int r = 1; r < repetitions_; ++r) {
+            std::tie(seconds, cpuSeconds, items) = timeOnce(b, threads, payload, iterations);
+            ns.push_back(seconds * 1e9 / items);
+            cpuNs.push_back(cpuSeconds * 1e9 / items);
+        }
+        std::sort(ns.begin(), ns.end());
+        std::sort(cpuNs.begin(), cpuNs.end());
+        double median = ns[ns.size() / 2];
+        std::string name = b.name + "/threads:" + std::to_string(threads) + "/payload:" + std::to_string(payload);
+        double cpuMedian = cpuNs[cpuNs.size() / 2];
+        return {name, b.name, threads, payload, iterations, median, ns.front(), ns.back(), cpuMedian, 1e9 / median};
+    }
+
+    void writeJson(const std::vector<Result>& results) const {
+        std::ofstream out(jsonPath_);
+        if (!out) {
+            throw std::runtime_error("can not write " + jsonPath_);
+        }
+        char date[64];
+        std::time_t now = std::time(nullptr);
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+        char host[256] = "unknown";
+        gethostname(host, sizeof(host) - 1);
+
+        out << "{\n  \"context\": {\n";
+        out << "    \"date\": \"" << date << "\",\n";
+        out << "    \"host_name\": \"" << jsonEscape(host) << "\",\n";
+        out << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+        out << "    \"compiler\": \"" << jsonEscape(__VERSION__) << "\",\n";
+#ifdef NDEBUG
+        out << "    \"library_build_type\": \"release\",\n";
+#else
+        out << "    \"library_build_type\": \"debug\",\n";
+#endif
+        for (const auto& [key, value] : context_) {
+            out << "    \"" << jsonEscape(key) << "\": \"" << jsonEscape(value) << "\",\n";
+        }
+        out << "    \"min_time\": " << minTime_ << ",\n";
+        out << "    \"repetitions\": " << repetitions_ << "\n  },\n";
+        out << "  \"benchmarks\": [";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            out << (i ? ",\n" : "\n") << "    {\n";
+            out << "      \"name\": \"" << jsonEscape(r.name) << "\",\n";
+            out << "      \"run_name\": \"" << jsonEscape(r.benchmark) << "\",\n";
+            out << "      \"run_type\": \"aggregate\",\n";
+            out << "      \"aggregate_name\": \"median\",\n";
+            out << "      \"threads\": " << r.threads << ",\n";
+            out << "      \"payload\": " << r.payload << ",\n";
+            out << "      \"iterations\": " << r.iterations << ",\n";
+            out << "      \"real_time\": " << r.nsPerOp << ",\n";
+            out << "      \"cpu_time\": " << r.cpuNsPerOp << ",\n";
+            out << "      \"min_time_ns\": " << r.minNsPerOp << ",\n";
+            out << "      \"max_time_ns\": " << r.maxNsPerOp << ",\n";
+            out << "      \"time_unit\": \"ns\",\n";
+            out << "      \"items_per_second\": " << r.itemsPerSecond << "\n    }";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+public:
+    Benchmark& add(std::string name, std::function<void(Run&)> fn) {
+        benchmarks_.push_back({std::move(name), std::move(fn)});
+        return benchmarks_.back();
+    }
+
+    void parseArgs(int argc, char* argv[]) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto value = [&](const std::string& prefix) { return arg.substr(prefix.size()); };
+            if (arg.rfind("--filter=", 0) == 0) {
+                filter_ = value("--filter=");
+            } else if (arg.rfind("--min_time=", 0) == 0) {
+                minTime_ = std::stod(value("--min_time="));
+            } else if (arg.rfind("--repetitions=", 0) == 0) {
+                repetitions_ = std::max(1, std::stoi(value("--repetitions=")));
+            } else if (arg.rfind("--threads=", 0) == 0) {
+                threadsOverride_ = parseList(value("--threads="));
+            } else if (arg.rfind("--payloads=", 0) == 0) {
+                payloadsOverride_ = parseList(value("--payloads="));
+            } else if (arg.rfind("--json=", 0) == 0) {
+                jsonPath_ = value("--json=");
+            } else if (arg.rfind("--context=", 0) == 0) {
+                std::string kv = value("--context=");
+                size_t eq = kv.find('=');
+                if (eq == std::string::npos) {
+                    throw std::invalid_argument("--context expects key=value: " + kv);
+                }
+                context_.emplace_back(kv.substr(0, eq), kv.substr(eq + 1));
+            } else {
+                throw std::invalid_argument("unknown option " + arg);
+            }
+        }
+    }
+
+    std::vector<Result> runAll() {
+        std::vector<Result> results;
+        std::cout << std::left << std::setw(52) << "benchmark" << std::right << std::setw(12) << "ns/op"
+                  << std::setw(12) << "min" << std::setw(12) << "max" << std::setw(12) << "cpu ns/op"
+                  << std::setw(14) << "ops/s" << std::endl;
+        for (const Benchmark& b : benchmarks_) {
+            if (b.name.find(filter_) == std::string::npos) {
+                continue;
+            }
+            const auto& threadCounts = threadsOverride_.empty() ? b.threadCounts : threadsOverride_;
+            const auto& payloads = payloadsOverride_.empty() ? b.payloads : payloadsOverride_;
+            for (size_t threads : threadCounts) {
+                if (threads < b.minThreadCount) {
+                    std::cout << b.name << "/threads:" << threads << " skipped: needs at least " << b.minThreadCount
+                              << " threads" << std::endl;
+                    continue;
+                }
+                for (size_t payload : payloads) {
+                    Result r = measure(b, threads, payload);
+                    std::cout << std::left << std::setw(52) << r.name << std::right << std::fixed
+                              << std::setprecision(1) << std::setw(12) << r.nsPerOp << std::setw(12) << r.minNsPerOp
+                              << std::setw(12) << r.maxNsPerOp << std::setw(12) << r.cpuNsPerOp
+                              << std::setprecision(0) << std::setw(14)
+                              << r.itemsPerSecond << std::endl;
+                    results.push_back(std::move(r));
+                }
+            }
+        }
+        if (!jsonPath_.empty()) {
+            writeJson(results);
+            std::cout << "wrote " << jsonPath_ << std::endl;
+        }
+        return results;
+    }
+};
+
+// keeps the compiler from optimizing a result away
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+} // namespace bench
+
+#endif // BENCH_SUITE_HPP
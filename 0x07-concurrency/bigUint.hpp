@@ -0,0 +1,344 @@
+#ifndef BIG_UINT_HPP
+#define BIG_UINT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+#include "threadPool.hpp"
+
+// BigUint: an arbitrary-precision unsigned integer, enough to compute n! for large n.
+// The examples compute factorial(n) in an int, which overflows at 13!; 10^6! has 5.5 million decimal digits.
+// * limbs are 32-bit (little endian), so a limb product fits in a uint64_t;
+// * multiplication is schoolbook O(n*m) for small numbers and Karatsuba O(n^1.585) above
+//   `karatsubaThreshold` limbs: (a1*B + a0)(b1*B + b0) needs only the three products a0*b0, a1*b1 and
+//   (a0+a1)(b0+b1) instead of four;
+// * bigFactorial() multiplies the numbers in a product tree: balanced halves keep the two operands of every
+//   multiplication the same size, which is where Karatsuba pays off (multiplying a huge running product by
+//   one small number at a time would be O(n^2) whatever the algorithm);
+// * parallelFactorial() computes the leaves of the tree on a ThreadPool, then every level of the tree; when a
+//   level has fewer products than workers, each product is split into its three Karatsuba halves.
+
+enum class MulAlgorithm { schoolbook, karatsuba };
+
+namespace bignum {
+
+using Limbs = std::vector<uint32_t>;
+using View = std::span<const uint32_t>;
+
+inline constexpr size_t karatsubaThreshold = 40;
+
+inline View trimmed(View v) {
+    size_t n = v.size();
+    while (n > 0 && v[n - 1] == 0) {
+        --n;
+    }
+    return v.first(n);
+}
+
+inline void trim(Limbs& v) {
+    while (!v.empty() && v.back() == 0) {
+        v.pop_back();
+    }
+}
+
+// r += x << (32 * offset); r must be big enough for the result
+inline void addAt(Limbs& r, View x, size_t offset) {
+    uint64_t carry = 0;
+    size_t i = 0;
+    for (; i < x.size(); ++i) {
+        uint64_t s = static_cast<uint64_t>(r[offset + i]) + x[i] + carry;
+        r[offset + i] = static_cast<uint32_t>(s);
+        carry = s >> 32;
+    }
+    for (size_t k = offset + i; carry && k < r.size(); ++k) {
+        uint64_t s = static_cast<uint64_t>(r[k]) + carry;
+        r[k] = static_cast<uint32_t>(s);
+        carry = s >> 32;
+    }
+}
+
+// r -= x, with r >= x
+inline void subInPlace(Limbs& r, View x) {
+    int64_t borrow = 0;
+    size_t i = 0;
+    for (; i < x.size(); ++i) {
+        int64_t d = static_cast<int64_t>(r[i]) - x[i] - borrow;
+        borrow = d < 0;
+        r[i] = static_cast<uint32_t>(d + (borrow << 32));
+    }
+    for (; borrow && i < r.size(); ++i) {
+        int64_t d = static_cast<int64_t>(r[i]) - borrow;
+        borrow = d < 0;
+        r[i] = static_cast<uint32_t>(d + (borrow << 32));
+    }
+}
+
+inline Limbs add(View a, View b) {
+    if (a.size() < b.size()) {
+        std::swap(a, b);
+    }
+    Limbs r(a.begin(), a.end());
+    r.push_back(0);
+    addAt(r, b, 0);
+    trim(r);
+    return r;
+}
+
+inline Limbs mulSchoolbook(View a, View b) {
+    a = trimmed(a);
+    b = trimmed(b);
+    if (a.empty() || b.empty()) {
+        return {};
+    }
+    Limbs r(a.size() + b.size(), 0);
+    for (size_t i = 0; i < a.size(); ++i) {
+        uint64_t carry = 0;
+        uint64_t ai = a[i];
+        for (size_t j = 0; j < b.size(); ++j) {
+            uint64_t t = ai * b[j] + r[i + j] + carry;
+            r[i + j] = static_cast<uint32_t>(t);
+            carry = t >> 32;
+        }
+        r[i + b.size()] = static_cast<uint32_t>(carry);
+    }
+    trim(r);
+    return r;
+}
+
+inline Limbs mulKaratsuba(View a, View b);
+
+// the three Karatsuba products of a*b split at limb m: a0*b0, a1*b1, (a0+a1)(b0+b1)
+struct KaratsubaSplit {
+    size_t m;
+    View a0, a1, b0, b1;
+};
+
+inline KaratsubaSplit splitAt(View a, View b) {
+    size_t m = std::max(a.size(), b.size()) / 2;
+    return {m, trimmed(a.first(m)), a.subspan(m), trimmed(b.first(m)), b.subspan(m)};
+}
+
+// z0 + (z1 - z0 - z2) << m + z2 << 2m, where z1 = (a0+a1)(b0+b1)
+inline Limbs combineKaratsuba(size_t m, size_t resultSize, const Limbs& z0, Limbs z1, const Limbs& z2) {
+    subInPlace(z1, z0);
+    subInPlace(z1, z2);
+    trim(z1);
+    Limbs r(resultSize + 1, 0);
+    addAt(r, z0, 0);
+    addAt(r, z1, m);
+    addAt(r, z2, 2 * m);
+    trim(r);
+    return r;
+}
+
+inline Limbs mulKaratsuba(View a, View b) {
+    a = trimmed(a);
+    b = trimmed(b);
+    if (a.size() < b.size()) {
+        std::swap(a, b);
+    }
+    if (b.size() < karatsubaThreshold) {
+        return mulSchoolbook(a, b);
+    }
+    if (b.size() <= a.size() / 2) {
+        // unbalanced: multiply b by a in slices of b's size
+        Limbs r(a.size() + b.size() + 1, 0);
+        for (size_t off = 0; off < a.size(); off += b.size()) {
+            Limbs part = mulKaratsuba(a.subspan(off, std::min(b.size(), a.size() - off)), b);
+            addAt(r, part, off);
+        }
+        trim(r);
+        return r;
+    }
+    KaratsubaSplit s = splitAt(a, b);
+    Limbs z0 = mulKaratsuba(s.a0, s.b0);
+    Limbs z2 = mulKaratsuba(s.a1, s.b1);
+    Limbs z1 = mulKaratsuba(add(s.a0, s.a1), add(s.b0, s.b1));
+    return combineKaratsuba(s.m, a.size() + b.size(), z0, std::move(z1), z2);
+}
+
+inline Limbs multiply(View a, View b, MulAlgorithm algo) {
+    return algo == MulAlgorithm::karatsuba ? mulKaratsuba(a, b) : mulSchoolbook(a, b);
+}
+
+// lo * (lo+1) * ... * (hi-1), as a product tree
+inline Limbs productRange(uint32_t lo, uint32_t hi, MulAlgorithm algo) {
+    if (hi - lo <= 16) {
+        Limbs r{1};
+        for (uint32_t k = lo; k < hi; ++k) {
+            uint64_t carry = 0;
+            for (auto& limb : r) {
+                uint64_t t = static_cast<uint64_t>(limb) * k + carry;
+                limb = static_cast<uint32_t>(t);
+                carry = t >> 32;
+            }
+            if (carry) {
+                r.push_back(static_cast<uint32_t>(carry));
+            }
+        }
+        return r;
+    }
+    uint32_t mid = lo + (hi - lo) / 2;
+    Limbs left = productRange(lo, mid, algo);
+    Limbs right = productRange(mid, hi, algo);
+    return multiply(left, right, algo);
+}
+
+// runs every job on the pool and waits for all of them (called from outside the pool)
+inline std::vector<Limbs> runAll(ThreadPool& pool, std::vector<std::packaged_task<Limbs()>> jobs) {
+    std::vector<std::future<Limbs>> futures;
+    futures.reserve(jobs.size());
+    for (auto& job : jobs) {
+        futures.push_back(job.get_future());
+        pool.post(std::move(job));
+    }
+    std::vector<Limbs> results;
+    results.reserve(futures.size());
+    for (auto& f : futures) {
+        results.push_back(f.get());
+    }
+    return results;
+}
+
+} // namespace bignum
+
+class BigUint {
+private:
+    bignum::Limbs limbs_; // no leading zero limbs; empty is 0
+
+public:
+    BigUint() = default;
+    BigUint(uint64_t v) {
+        while (v) {
+            limbs_.push_back(static_cast<uint32_t>(v));
+            v >>= 32;
+        }
+    }
+    explicit BigUint(bignum::Limbs limbs) : limbs_(std::move(limbs)) { bignum::trim(limbs_); }
+
+    const bignum::Limbs& limbs() const { return limbs_; }
+
+    size_t bitLength() const {
+        if (limbs_.empty()) {
+            return 0;
+        }
+        size_t bits = 32 * (limbs_.size() - 1);
+        for (uint32_t top = limbs_.back(); top; top >>= 1) {
+            ++bits;
+        }
+        return bits;
+    }
+
+    BigUint multiply(const BigUint& other, MulAlgorithm algo = MulAlgorithm::karatsuba) const {
+        return BigUint(bignum::multiply(limbs_, other.limbs_, algo));
+    }
+
+    friend BigUint operator*(const BigUint& a, const BigUint& b) { return a.multiply(b); }
+    friend bool operator==(const BigUint& a, const BigUint& b) { return a.limbs_ == b.limbs_; }
+
+    // decimal digits; repeated division by 10^9, O(n^2): fine for printing, not for millions of digits
+    std::string toString() const {
+        if (limbs_.empty()) {
+            return "0";
+        }
+        bignum::Limbs v = limbs_;
+        std::vector<uint32_t> chunks; // base 10^9, least significant first
+        while (!v.empty()) {
+            uint64_t rem = 0;
+            for (size_t i = v.size(); i-- > 0;) {
+                uint64_t cur = (rem << 32) | v[i];
+                v[i] = static_cast<uint32_t>(cur / 1'000'000'000);
+                rem = cur % 1'000'000'000;
+            }
+            chunks.push_back(static_cast<uint32_t>(rem));
+            bignum::trim(v);
+        }
+        std::string s = std::to_string(chunks.back());
+        for (size_t i = chunks.size() - 1; i-- > 0;) {
+            std::string part = std::to_string(chunks[i]);
+            s += std::string(9 - part.size(), '0') + part;
+        }
+        return s;
+    }
+};
+
+// n! on the calling thread; a drop-in replacement for the int factorial(n) of the examples
+// (std::async(std::launch::async, bigFactorial, 100) works the same way)
+inline BigUint bigFactorial(uint32_t n, MulAlgorithm algo = MulAlgorithm::karatsuba) {
+    return BigUint(bignum::productRange(1, n + 1, algo));
+}
+
+// n! with the product tree spread over `pool` (call it from outside the pool: it waits for the pool's tasks)
+inline BigUint parallelFactorial(uint32_t n, ThreadPool& pool) {
+    using bignum::Limbs;
+    const size_t workers = std::max<size_t>(1, pool.size());
+    if (n < 1000) {
+        return bigFactorial(n);
+    }
+
+    // leaves: 4 ranges per worker, so a slow range does not leave the others idle
+    const size_t leaves = 4 * workers;
+    std::vector<std::packaged_task<Limbs()>> jobs;
+    for (size_t i = 0; i < leaves; ++i) {
+        uint32_t lo = static_cast<uint32_t>(1 + static_cast<uint64_t>(n) * i / leaves);
+        uint32_t hi = static_cast<uint32_t>(1 + static_cast<uint64_t>(n) * (i + 1) / leaves);
+        jobs.emplace_back([lo, hi] { return bignum::productRange(lo, hi, MulAlgorithm::karatsuba); });
+    }
+    std::vector<Limbs> parts = bignum::runAll(pool, std::move(jobs));
+
+    // the levels of the tree above the leaves
+    while (parts.size() > 1) {
+        size_t pairs = parts.size() / 2;
+        std::vector<Limbs> next;
+        jobs.clear();
+        if (pairs >= workers) {
+            for (size_t p = 0; p < pairs; ++p) {
+                jobs.emplace_back([a = &parts[2 * p], b = &parts[2 * p + 1]] { return bignum::mulKaratsuba(*a, *b); });
+            }
+            next = bignum::runAll(pool, std::move(jobs));
+        } else {
+            // too few products to keep the workers busy: run the three Karatsuba halves of each one in parallel
+            // (an unbalanced pair, e.g. with the odd part carried up from a lower level, stays one job)
+            std::vector<std::pair<bignum::KaratsubaSplit, bool>> splits;
+            for (size_t p = 0; p < pairs; ++p) {
+                bignum::View a = parts[2 * p], b = parts[2 * p + 1];
+                if (a.size() < b.size()) {
+                    std::swap(a, b);
+                }
+                if (b.size() <= a.size() / 2 || b.size() < bignum::karatsubaThreshold) {
+                    splits.push_back({{}, false});
+                    jobs.emplace_back([a, b] { return bignum::mulKaratsuba(a, b); });
+                    continue;
+                }
+                bignum::KaratsubaSplit s = bignum::splitAt(a, b);
+                splits.push_back({s, true});
+                jobs.emplace_back([s] { return bignum::mulKaratsuba(s.a0, s.b0); });
+                jobs.emplace_back([s] { return bignum::mulKaratsuba(s.a1, s.b1); });
+                jobs.emplace_back([s] { return bignum::mulKaratsuba(bignum::add(s.a0, s.a1), bignum::add(s.b0, s.b1)); });
+            }
+            std::vector<Limbs> z = bignum::runAll(pool, std::move(jobs));
+            size_t j = 0;
+            for (size_t p = 0; p < pairs; ++p) {
+                if (!splits[p].second) {
+                    next.push_back(std::move(z[j++]));
+                    continue;
+                }
+                size_t size = parts[2 * p].size() + parts[2 * p + 1].size();
+                next.push_back(bignum::combineKaratsuba(splits[p].first.m, size, z[j], std::move(z[j + 2]), z[j + 1]));
+                j += 3;
+            }
+        }
+        if (parts.size() % 2) {
+            next.push_back(std::move(parts.back()));
+        }
+        parts = std::move(next);
+    }
+    return BigUint(std::move(parts.front()));
+}
+
+#endif // BIG_UINT_HPP
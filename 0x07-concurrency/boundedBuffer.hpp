@@ -0,0 +1,157 @@
+#ifndef BOUNDED_BUFFER_HPP
+#define BOUNDED_BUFFER_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+// BoundedBuffer<T>: the producer/consumer buffer of 0x13-condition_variables.cpp as a reusable class.
+// * capacity limit: push() waits while the buffer is full, so a fast producer can not eat all the memory;
+// * batches: push_batch() and pop_batch() move many items under one lock, and a consumer wakes up once
+//   per batch instead of once per item;
+// * notifications are only sent when somebody is actually waiting;
+// * shutdown: close() makes every push fail, and the consumers drain what is left before they get 0 items.
+template <typename T>
+class BoundedBuffer {
+private:
+    std::deque<T> buffer_;
+    const size_t capacity_;
+    bool closed_ = false;
+    size_t waitingConsumers_ = 0;
+    size_t waitingProducers_ = 0;
+    size_t consumerWaits_ = 0; // times a consumer had to sleep (for statistics)
+    mutable std::mutex mtx_;
+    std::condition_variable notEmpty_;
+    std::condition_variable notFull_;
+
+    // mtx_ must be held
+    void waitForSpace(std::unique_lock<std::mutex>& lock) {
+        ++waitingProducers_;
+        notFull_.wait(lock, [this] { return closed_ || buffer_.size() < capacity_; });
+        --waitingProducers_;
+    }
+
+    void wakeConsumers(std::unique_lock<std::mutex>& lock, size_t added) {
+        bool wake = waitingConsumers_ > 0;
+        lock.unlock(); // the woken thread does not have to wait for our mutex
+        if (wake) {
+            if (added > 1) notEmpty_.notify_all(); else notEmpty_.notify_one();
+        }
+    }
+
+public:
+    explicit BoundedBuffer(size_t capacity) : capacity_(capacity > 0 ? capacity : 1) {}
+
+    BoundedBuffer(const BoundedBuffer&) = delete;
+    BoundedBuffer& operator=(const BoundedBuffer&) = delete;
+
+    // waits for space; returns false if the buffer is closed
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        if (buffer_.size() >= capacity_) {
+            waitForSpace(lock);
+        }
+        if (closed_) {
+            return false;
+        }
+        buffer_.push_back(std::move(item));
+        wakeConsumers(lock, 1);
+        return true;
+    }
+
+    // pushes [first, last), waiting for space as needed; returns the number of items pushed
+    // (less than the whole range only if the buffer was closed in the meantime)
+    template <typename It>
+    size_t push_batch(It first, It last) {
+        size_t pushed = 0;
+        while (first != last) {
+            std::unique_lock<std::mutex> lock(mtx_);
+            if (buffer_.size() >= capacity_) {
+                waitForSpace(lock);
+            }
+            if (closed_) {
+                return pushed;
+            }
+            size_t added = 0;
+            while (first != last && buffer_.size() < capacity_) {
+                buffer_.push_back(std::move(*first));
+                ++first;
+                ++added;
+            }
+            pushed += added;
+            wakeConsumers(lock, added);
+        }
+        return pushed;
+    }
+
+    // Moves up to `max_n` items into `out`, waiting at most `timeout` for the first one.
+    // Returns the number of items moved: 0 means timeout, or closed and fully drained (check drained()).
+    template <typename Rep, typename Period>
+    size_t pop_batch(std::vector<T>& out, size_t max_n, std::chrono::duration<Rep, Period> timeout) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        if (buffer_.empty() && !closed_) {
+            ++waitingConsumers_;
+            ++consumerWaits_;
+            notEmpty_.wait_for(lock, timeout, [this] { return closed_ || !buffer_.empty(); });
+            --waitingConsumers_;
+        }
+        size_t n = 0;
+        while (n < max_n && !buffer_.empty()) {
+            out.push_back(std::move(buffer_.front()));
+            buffer_.pop_front();
+            ++n;
+        }
+        bool wake = n > 0 && waitingProducers_ > 0;
+        lock.unlock();
+        if (wake) {
+            notFull_.notify_all();
+        }
+        return n;
+    }
+
+    // waits for one item; std::nullopt once the buffer is closed and empty
+    std::optional<T> pop() {
+        std::vector<T> one;
+        while (pop_batch(one, 1, std::chrono::hours(1)) == 0) {
+            if (drained()) {
+                return std::nullopt;
+            }
+        }
+        return std::move(one.front());
+    }
+
+    // no more items will be accepted; consumers still get the items that are in the buffer
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            closed_ = true;
+        }
+        notEmpty_.notify_all();
+        notFull_.notify_all();
+    }
+
+    bool closed() const {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return closed_;
+    }
+    // closed and nothing left to consume
+    bool drained() const {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return closed_ && buffer_.empty();
+    }
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return buffer_.size();
+    }
+    size_t capacity() const { return capacity_; }
+    size_t consumerWaits() const {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return consumerWaits_;
+    }
+};
+
+#endif // BOUNDED_BUFFER_HPP
@@ -0,0 +1,428 @@
+#ifndef CORO_TASK_HPP
+#define CORO_TASK_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// C++20 coroutines for I/O-bound work.
+// A thread that waits (sleep_for in query_database of 0x19, a socket read, ...) is an 8MB stack (virtual)
+// and a kernel task doing nothing. A coroutine that waits is a heap-allocated frame of a few hundred bytes:
+// `co_await sleep_for(2s)` registers the coroutine with the scheduler's timers and returns the thread to the
+// scheduler, which runs other coroutines in the meantime.
+//
+//     coro::Task<std::string> query(int id) {
+//         co_await coro::sleep_for(std::chrono::seconds(2));
+//         co_return "Result of query " + std::to_string(id);
+//     }
+//     coro::Scheduler scheduler(4);
+//     std::vector<std::string> all = coro::syncWait(scheduler, coro::when_all(std::move(queries)));
+namespace coro {
+
+class Scheduler;
+template <typename T = void> class Task;
+
+namespace detail {
+
+// the scheduler whose thread is running the current coroutine (sleep_for needs it)
+inline thread_local Scheduler* currentScheduler = nullptr;
+
+// at the end of a Task, resume whoever co_awaited it (symmetric transfer: no stack growth)
+struct FinalAwaiter {
+    bool await_ready() noexcept { return false; }
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) noexcept {
+        std::coroutine_handle<> continuation = h.promise().continuation;
+        return continuation ? continuation : std::noop_coroutine();
+    }
+    void await_resume() noexcept {}
+};
+
+struct PromiseBase {
+    std::coroutine_handle<> continuation;
+    std::exception_ptr error;
+
+    std::suspend_always initial_suspend() noexcept { return {}; } // lazy: starts when co_awaited
+    FinalAwaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() { error = std::current_exception(); }
+};
+
+template <typename T>
+struct TaskPromise : PromiseBase {
+    std::optional<T> value;
+
+    Task<T> get_return_object();
+    template <typename U>
+    void return_value(U&& v) { value.emplace(std::forward<U>(v)); }
+    T result() {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return std::move(*value);
+    }
+};
+
+template <>
+struct TaskPromise<void> : PromiseBase {
+    Task<void> get_return_object();
+    void return_void() {}
+    void result() {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+};
+
+} // namespace detail
+
+// Task<T>: a lazy coroutine returning T. It starts when it is co_awaited and owns its frame.
+template <typename T>
+class [[nodiscard]] Task {
+public:
+    using promise_type = detail::TaskPromise<T>;
+
+    explicit Task(std::coroutine_handle<promise_type> h) : h_(h) {}
+    Task(Task&& other) noexcept : h_(std::exchange(other.h_, {})) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (h_) {
+                h_.destroy();
+            }
+            h_ = std::exchange(other.h_, {});
+        }
+        return *this;
+    }
+    ~Task() {
+        if (h_) {
+            h_.destroy();
+        }
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    // `co_await std::move(task)` (or `co_await makeTask()`): runs the task, the result is its co_return value
+    auto operator co_await() && noexcept {
+        struct Awaiter {
+            std::coroutine_handle<promise_type> h;
+            bool await_ready() noexcept { return !h || h.done(); }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+                h.promise().continuation = caller;
+                return h; // start the task right away on this thread
+            }
+            T await_resume() { return h.promise().result(); }
+        };
+        return Awaiter{h_};
+    }
+
+private:
+    std::coroutine_handle<promise_type> h_;
+};
+
+namespace detail {
+
+template <typename T>
+Task<T> TaskPromise<T>::get_return_object() {
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() {
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+// a fire-and-forget coroutine: runs eagerly and frees its own frame at the end
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+} // namespace detail
+
+// Scheduler: an event loop run by `threads` threads, with a ready queue and a timer heap.
+// The scheduler must outlive the coroutines that run on it.
+class Scheduler {
+private:
+    using Clock = std::chrono::steady_clock;
+    struct Timer {
+        Clock::time_point when;
+        uint64_t seq; // keeps timers with the same deadline in FIFO order
+        std::coroutine_handle<> h;
+        bool operator>(const Timer& other) const {
+            return when != other.when ? when > other.when : seq > other.seq;
+        }
+    };
+
+    std::deque<std::coroutine_handle<>> ready_;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<>> timers_;
+    uint64_t nextSeq_ = 0;
+    bool stopping_ = false;
+    mutable std::mutex mtx_;
+    std::condition_variable cv_;
+    std::vector<std::thread> threads_;
+
+    void run() {
+        detail::currentScheduler = this;
+        std::unique_lock<std::mutex> lock(mtx_);
+        while (true) {
+            auto now = Clock::now();
+            while (!timers_.empty() && timers_.top().when <= now) {
+                ready_.push_back(timers_.top().h);
+                timers_.pop();
+            }
+            if (!ready_.empty()) {
+                std::coroutine_handle<> h = ready_.front();
+                ready_.pop_front();
+                if (!ready_.empty()) {
+                    cv_.notify_one(); // more work: let another thread help
+                }
+                lock.unlock();
+                h.resume();
+                lock.lock();
+                continue;
+            }
+            if (stopping_) {
+                return;
+            }
+            if (timers_.empty()) {
+                cv_.wait(lock);
+            } else {
+                cv_.wait_until(lock, timers_.top().when);
+            }
+        }
+    }
+
+public:
+    explicit Scheduler(size_t threads = 1) {
+        if (threads == 0) {
+            threads = 1;
+        }
+        for (size_t i = 0; i < threads; ++i) {
+            threads_.emplace_back([this] { run(); });
+        }
+    }
+
+    // runs what is ready, drops pending timers, joins the threads
+    ~Scheduler() {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        for (auto& t : threads_) {
+            t.join();
+        }
+    }
+
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    // resume `h` on one of the scheduler threads
+    void post(std::coroutine_handle<> h) {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            ready_.push_back(h);
+        }
+        cv_.notify_one();
+    }
+
+    // resume `h` on one of the scheduler threads at `when`
+    void postAt(Clock::time_point when, std::coroutine_handle<> h) {
+        bool earliest;
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            earliest = timers_.empty() || when < timers_.top().when;
+            timers_.push({when, nextSeq_++, h});
+        }
+        if (earliest) {
+            cv_.notify_one(); // a sleeping thread has to wake up earlier than planned
+        }
+    }
+
+    // `co_await scheduler.schedule()` moves the coroutine onto a scheduler thread
+    auto schedule() {
+        struct Awaiter {
+            Scheduler& s;
+            bool await_ready() noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> h) { s.post(h); }
+            void await_resume() noexcept {}
+        };
+        return Awaiter{*this};
+    }
+
+    size_t pendingTimers() const {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return timers_.size();
+    }
+    size_t threadCount() const { return threads_.size(); }
+};
+
+// suspends the coroutine for `d` without blocking the thread; must run on a scheduler thread
+inline auto sleep_for(std::chrono::steady_clock::duration d) {
+    struct Awaiter {
+        std::chrono::steady_clock::duration d;
+        bool await_ready() const noexcept { return d <= d.zero(); }
+        void await_suspend(std::coroutine_handle<> h) {
+            Scheduler* s = detail::currentScheduler;
+            if (!s) {
+                throw std::logic_error("coro::sleep_for: not running on a coro::Scheduler thread");
+            }
+            s->postAt(std::chrono::steady_clock::now() + d, h);
+        }
+        void await_resume() noexcept {}
+    };
+    return Awaiter{d};
+}
+
+namespace detail {
+
+struct WhenAllCounter {
+    std::atomic<size_t> remaining{0};
+    std::coroutine_handle<> parent;
+};
+
+// a child of when_all: when it finishes, the last child to finish resumes the parent
+struct WhenAllChild {
+    struct promise_type {
+        WhenAllCounter* counter = nullptr;
+
+        WhenAllChild get_return_object() {
+            return WhenAllChild{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        auto final_suspend() noexcept {
+            struct Awaiter {
+                bool await_ready() noexcept { return false; }
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+                    WhenAllCounter* c = h.promise().counter;
+                    if (c->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                        return c->parent;
+                    }
+                    return std::noop_coroutine();
+                }
+                void await_resume() noexcept {}
+            };
+            return Awaiter{};
+        }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); } // the child body catches everything
+    };
+    std::coroutine_handle<promise_type> h;
+};
+
+template <typename T>
+using Stored = std::conditional_t<std::is_void_v<T>, bool, T>;
+
+} // namespace detail
+
+template <typename T>
+using WhenAllResult = std::conditional_t<std::is_void_v<T>, void, std::vector<T>>;
+
+// Runs all the tasks concurrently (each one runs until its first suspension, then the next one starts)
+// and completes when all of them are done: their values in input order, or the first exception.
+template <typename T>
+Task<WhenAllResult<T>> when_all(std::vector<Task<T>> tasks) {
+    detail::WhenAllCounter counter;
+    std::vector<std::optional<detail::Stored<T>>> values(tasks.size());
+    std::exception_ptr error;
+    std::mutex errorMtx;
+
+    auto child = [](Task<T> task, std::optional<detail::Stored<T>>& slot, std::exception_ptr& err,
+                    std::mutex& errMtx) -> detail::WhenAllChild {
+        try {
+            if constexpr (std::is_void_v<T>) {
+                co_await std::move(task);
+                slot.emplace(true);
+            } else {
+                slot.emplace(co_await std::move(task));
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errMtx);
+            if (!err) {
+                err = std::current_exception();
+            }
+        }
+    };
+    std::vector<std::coroutine_handle<detail::WhenAllChild::promise_type>> children;
+    children.reserve(tasks.size());
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        children.push_back(child(std::move(tasks[i]), values[i], error, errorMtx).h);
+        children.back().promise().counter = &counter;
+    }
+
+    struct StartAll {
+        detail::WhenAllCounter& counter;
+        std::vector<std::coroutine_handle<detail::WhenAllChild::promise_type>>& children;
+        bool await_ready() noexcept { return children.empty(); }
+        bool await_suspend(std::coroutine_handle<> parent) {
+            counter.parent = parent;
+            counter.remaining.store(children.size() + 1, std::memory_order_relaxed); // +1: ourselves
+            for (auto h : children) {
+                h.resume();
+            }
+            return counter.remaining.fetch_sub(1, std::memory_order_acq_rel) != 1; // false: all done already
+        }
+        void await_resume() noexcept {}
+    };
+    co_await StartAll{counter, children};
+
+    for (auto h : children) {
+        h.destroy();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    if constexpr (!std::is_void_v<T>) {
+        std::vector<T> out;
+        out.reserve(values.size());
+        for (auto& v : values) {
+            out.push_back(std::move(*v));
+        }
+        co_return out;
+    }
+}
+
+// Runs `task` on the scheduler and blocks the calling (non-scheduler) thread until it is done.
+template <typename T>
+T syncWait(Scheduler& scheduler, Task<T> task) {
+    std::promise<T> promise;
+    std::future<T> result = promise.get_future();
+    auto runner = [](Scheduler& s, Task<T> t, std::promise<T> p) -> detail::Detached {
+        co_await s.schedule();
+        try {
+            if constexpr (std::is_void_v<T>) {
+                co_await std::move(t);
+                p.set_value();
+            } else {
+                p.set_value(co_await std::move(t));
+            }
+        } catch (...) {
+            p.set_exception(std::current_exception());
+        }
+    };
+    runner(scheduler, std::move(task), std::move(promise));
+    return result.get();
+}
+
+} // namespace coro
+
+#endif // CORO_TASK_HPP
@@ -0,0 +1,252 @@
+#ifndef DEADLINE_SCHEDULER_HPP
+#define DEADLINE_SCHEDULER_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "threadGroup.hpp"
+
+// DeadlineScheduler: the task queue of 0x18/0x19, but not FIFO.
+// * priority classes: class 0 runs before class 1, which runs before class 2, ...;
+// * inside a class, earliest deadline first (EDF); tasks without a deadline come after those with one, in
+//   submission order;
+// * aging: once a task of a lower class has waited longer than `maxWait`, one pick in `agedEvery` goes to the
+//   oldest such task, so a steady stream of interactive work can not starve the batch work forever (and a
+//   backlog of aged batch work does not take every worker from the interactive tasks either);
+// * deadlines: submit() rejects a task whose deadline has already passed (DeadlineExpired thrown right away),
+//   and a task whose deadline passes while it is queued is dropped: its future gets DeadlineExpired instead
+//   of running late and delaying the tasks behind it.
+
+class DeadlineExpired : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+class DeadlineScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr Clock::time_point noDeadline = Clock::time_point::max();
+
+    struct ClassStats {
+        size_t ran = 0;
+        size_t aged = 0;     // ran early because of aging
+        size_t dropped = 0;  // deadline passed in the queue
+        size_t rejected = 0; // deadline passed before submit
+    };
+
+private:
+    struct Job {
+        virtual ~Job() = default;
+        virtual void run() = 0;
+        virtual void drop() = 0;
+    };
+
+    template <typename R, typename Fn>
+    struct JobImpl : Job {
+        std::promise<R> promise;
+        Fn fn;
+        explicit JobImpl(Fn f) : fn(std::move(f)) {}
+        void run() override {
+            try {
+                if constexpr (std::is_void_v<R>) {
+                    fn();
+                    promise.set_value();
+                } else {
+                    promise.set_value(fn());
+                }
+            } catch (...) {
+                promise.set_exception(std::current_exception());
+            }
+        }
+        void drop() override {
+            promise.set_exception(std::make_exception_ptr(DeadlineExpired("deadline passed while queued")));
+        }
+    };
+
+    struct Entry {
+        std::unique_ptr<Job> job;
+        Clock::time_point deadline;
+        Clock::time_point submitted;
+    };
+
+    // one priority class; a task is in both indexes
+    struct Class {
+        std::map<uint64_t, Entry> bySeq;                             // oldest first (for aging)
+        std::set<std::pair<Clock::time_point, uint64_t>> byDeadline; // earliest deadline first
+        ClassStats stats;
+    };
+
+    std::vector<Class> classes_;
+    const Clock::duration maxWait_;
+    const size_t agedEvery_;
+    size_t passedOver_ = 0; // picks since an aged task was last served
+    uint64_t nextSeq_ = 0;
+    size_t queued_ = 0;
+    mutable std::mutex mtx_;
+    std::condition_variable_any cv_;
+    ThreadGroup workers_; // last: joined before the queues are destroyed
+
+    // mtx_ must be held; removes the tasks whose deadline has passed (a deadline equal to `now` has passed,
+    // as in submit) and returns them
+    void collectExpired(Clock::time_point now, std::vector<std::unique_ptr<Job>>& expired) {
+        for (auto& c : classes_) {
+            while (!c.byDeadline.empty() && c.byDeadline.begin()->first <= now) {
+                uint64_t seq = c.byDeadline.begin()->second;
+                c.byDeadline.erase(c.byDeadline.begin());
+                auto it = c.bySeq.find(seq);
+                expired.push_back(std::move(it->second.job));
+                c.bySeq.erase(it);
+                ++c.stats.dropped;
+                --queued_;
+            }
+        }
+    }
+
+    // mtx_ must be held and queued_ > 0
+    std::unique_ptr<Job> takeNext(Clock::time_point now) {
+        Class* top = nullptr;
+        for (auto& c : classes_) {
+            if (!c.bySeq.empty()) {
+                top = &c;
+                break;
+            }
+        }
+        // aging: the task of a lower class that has waited the longest, if it waited more than maxWait
+        Class* aged = nullptr;
+        for (auto* c = top + 1; c != classes_.data() + classes_.size(); ++c) {
+            if (!c->bySeq.empty() && now - c->bySeq.begin()->second.submitted > maxWait_ &&
+                (!aged || c->bySeq.begin()->second.submitted < aged->bySeq.begin()->second.submitted)) {
+                aged = c;
+            }
+        }
+        Class* pick = top;
+        uint64_t seq;
+        if (aged && ++passedOver_ >= agedEvery_) {
+            pick = aged;
+            passedOver_ = 0;
+            ++pick->stats.aged;
+            seq = pick->bySeq.begin()->first;
+            pick->byDeadline.erase({pick->bySeq.begin()->second.deadline, seq});
+        } else {
+            seq = pick->byDeadline.begin()->second;
+            pick->byDeadline.erase(pick->byDeadline.begin());
+        }
+        auto it = pick->bySeq.find(seq);
+        std::unique_ptr<Job> job = std::move(it->second.job);
+        pick->bySeq.erase(it);
+        ++pick->stats.ran;
+        --queued_;
+        return job;
+    }
+
+    void workerLoop(std::stop_token token) {
+        std::vector<std::unique_ptr<Job>> expired;
+        while (true) {
+            std::unique_ptr<Job> job;
+            {
+                std::unique_lock<std::mutex> lock(mtx_);
+                if (!cv_.wait(lock, token, [this] { return queued_ > 0; })) {
+                    return;
+                }
+                auto now = Clock::now();
+                collectExpired(now, expired);
+                if (queued_ > 0) {
+                    job = takeNext(now);
+                }
+            }
+            for (auto& e : expired) {
+                e->drop();
+            }
+            expired.clear();
+            if (job) {
+                job->run();
+            }
+        }
+    }
+
+public:
+    // `classes` priority classes (0 is the most urgent), `threads` workers; see aging above for the rest
+    DeadlineScheduler(size_t classes, size_t threads, Clock::duration maxWait = std::chrono::seconds(1),
+                      size_t agedEvery = 4)
+        : classes_(classes > 0 ? classes : 1), maxWait_(maxWait), agedEvery_(agedEvery > 0 ? agedEvery : 1) {
+        for (size_t i = 0; i < (threads > 0 ? threads : 1); ++i) {
+            workers_.spawn({"sched-" + std::to_string(i), {}}, [this](std::stop_token token) { workerLoop(token); });
+        }
+    }
+
+    // the workers finish their current task; the tasks still queued are dropped (their futures get DeadlineExpired)
+    ~DeadlineScheduler() {
+        workers_.requestStop();
+        std::vector<std::unique_ptr<Job>> left;
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            for (auto& c : classes_) {
+                for (auto& [seq, entry] : c.bySeq) {
+                    left.push_back(std::move(entry.job));
+                }
+                c.bySeq.clear();
+                c.byDeadline.clear();
+            }
+            queued_ = 0; // a worker woken by the stop request now sees nothing to do and returns
+        }
+        for (auto& job : left) {
+            job->drop();
+        }
+    }
+
+    DeadlineScheduler(const DeadlineScheduler&) = delete;
+    DeadlineScheduler& operator=(const DeadlineScheduler&) = delete;
+
+    // queues fn() in class `priority` with an optional deadline; the future gets its result (or exception)
+    template <typename Fn>
+    auto submit(size_t priority, Clock::time_point deadline, Fn fn) -> std::future<std::invoke_result_t<Fn&>> {
+        using R = std::invoke_result_t<Fn&>;
+        auto job = std::make_unique<JobImpl<R, Fn>>(std::move(fn));
+        std::future<R> result = job->promise.get_future();
+        auto now = Clock::now();
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            Class& c = classes_.at(priority);
+            if (deadline <= now) {
+                ++c.stats.rejected;
+                throw DeadlineExpired("deadline already passed at submit");
+            }
+            uint64_t seq = nextSeq_++;
+            c.byDeadline.insert({deadline, seq});
+            c.bySeq.emplace(seq, Entry{std::move(job), deadline, now});
+            ++queued_;
+        }
+        cv_.notify_one();
+        return result;
+    }
+
+    template <typename Fn>
+    auto submit(size_t priority, Fn fn) {
+        return submit(priority, noDeadline, std::move(fn));
+    }
+
+    ClassStats stats(size_t priority) const {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return classes_.at(priority).stats;
+    }
+
+    size_t queued() const {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return queued_;
+    }
+};
+
+#endif // DEADLINE_SCHEDULER_HPP
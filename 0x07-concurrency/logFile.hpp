@@ -0,0 +1,34 @@
+#ifndef LOG_FILE_HPP
+#define LOG_FILE_HPP
+
+#include <fstream>
+#include <mutex>
+#include <string>
+#include "scopedTimer.hpp"
+
+// The mutex bundled together with the resource it protects (0x0B-thread_mutex.cpp): the file is only
+// accessed through shared_print, so no thread can write to it without holding the lock.
+class LogFile {
+public:
+    explicit LogFile(const std::string& path = "log.txt") {
+        file.open(path);
+    }
+
+    ~LogFile() {
+        file.close();
+    }
+
+    void shared_print(const std::string& message, const int& num) {
+        SCOPED_TIMER("LogFile::shared_print"); // includes the wait for the lock
+        std::lock_guard<std::mutex> guard(mtx);
+        // the file will only accessed shared_print function.
+        // "cout" is global, so it be accessed from anywhere in the program.
+        file << message << num << std::endl;
+    }
+
+private:
+    std::mutex mtx;
+    std::ofstream file;
+};
+
+#endif // LOG_FILE_HPP
@@ -0,0 +1,296 @@
+#ifndef NUMA_TOPOLOGY_HPP
+#define NUMA_TOPOLOGY_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stop_token>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "threadGroup.hpp"
+#include "threadPool.hpp"
+
+// NUMA (Non-Uniform Memory Access): on a multi-socket machine every socket has its own memory controller.
+// A core reads memory attached to its own socket ("node") faster than memory of another node, which has to go
+// over the socket interconnect. Linux places a page on the node of the thread that first writes it
+// ("first touch"), so a worker that allocates and fills its data and then keeps running on the same node only
+// touches local memory. A worker that floats to another socket (the scheduler may move it at any time) pays
+// the remote penalty on every cache miss.
+
+struct NumaNode {
+    int id;
+    std::vector<int> cpus;
+    // node<N>/distance: the relative cost of reaching each node's memory from this one, indexed by node id
+    // (10 is local; empty when sysfs does not say)
+    std::vector<int> distance = {};
+};
+
+// parses a kernel cpu list such as "0-3,8-11"
+inline std::vector<int> parseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream ss(list);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        if (range.empty() || range == "\n") {
+            continue;
+        }
+        size_t dash = range.find('-');
+        int first = std::stoi(range.substr(0, dash));
+        int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+        for (int c = first; c <= last; ++c) {
+            cpus.push_back(c);
+        }
+    }
+    return cpus;
+}
+
+class Topology {
+private:
+    std::vector<NumaNode> nodes_;
+    bool simulated_ = false;
+
+    // allowedCpus(), or CPUs 0..hardware_concurrency()-1 if the affinity mask can not be read: never empty, so
+    // every topology has CPUs to put its workers on
+    static std::vector<int> usableCpus() {
+        std::vector<int> cpus = allowedCpus();
+        if (cpus.empty()) {
+            unsigned count = std::max(1u, std::thread::hardware_concurrency());
+            for (unsigned c = 0; c < count; ++c) {
+                cpus.push_back(static_cast<int>(c));
+            }
+        }
+        return cpus;
+    }
+
+public:
+    // reads /sys/devices/system/node/node<N>/cpulist and distance, keeping only the CPUs this process may use;
+    // without NUMA support (or sysfs) the machine is one node with all the allowed CPUs
+    static Topology discover() {
+        Topology t;
+        std::vector<int> allowed = usableCpus();
+        namespace fs = std::filesystem;
+        std::error_code ec;
+        std::vector<NumaNode> all; // with the nodes that have no allowed CPU: the distances are listed for all
+        for (const auto& entry : fs::directory_iterator("/sys/devices/system/node", ec)) {
+            std::string name = entry.path().filename().string();
+            if (name.rfind("node", 0) != 0 || name.size() == 4 || !std::isdigit(static_cast<unsigned char>(name[4]))) {
+                continue;
+            }
+            std::ifstream in(entry.path() / "cpulist");
+            std::string list;
+            std::getline(in, list);
+            NumaNode node{std::stoi(name.substr(4)), {}};
+            for (int c : parseCpuList(list)) {
+                if (std::find(allowed.begin(), allowed.end(), c) != allowed.end()) {
+                    node.cpus.push_back(c);
+                }
+            }
+            std::ifstream distances(entry.path() / "distance");
+            for (int d; distances >> d;) {
+                node.distance.push_back(d);
+            }
+            all.push_back(std::move(node));
+        }
+        std::sort(all.begin(), all.end(), [](const NumaNode& a, const NumaNode& b) { return a.id < b.id; });
+        for (auto& node : all) {
+            // the k-th distance is to the k-th node in id order: index them by id
+            std::vector<int> byId;
+            for (size_t k = 0; k < node.distance.size() && k < all.size(); ++k) {
+                byId.resize(std::max(byId.size(), static_cast<size_t>(all[k].id) + 1), 0);
+                byId[all[k].id] = node.distance[k];
+            }
+            node.distance = std::move(byId);
+            if (!node.cpus.empty()) {
+                t.nodes_.push_back(std::move(node));
+            }
+        }
+        if (t.nodes_.empty()) {
+            t.nodes_.push_back({0, allowed});
+        }
+        return t;
+    }
+
+    // Pretends the allowed CPUs are split over `nodes` nodes (round robin, so with fewer CPUs than nodes a CPU
+    // belongs to several nodes). The placement logic can then run on a single-node box; the memory is not
+    // really remote, so there is no penalty to measure.
+    static Topology simulated(int nodes) {
+        if (nodes <= 0) {
+            throw std::invalid_argument("Topology::simulated: nodes must be > 0");
+        }
+        std::vector<int> allowed = usableCpus();
+        Topology t;
+        t.simulated_ = true;
+        for (int n = 0; n < nodes; ++n) {
+            t.nodes_.push_back({n, {}});
+        }
+        size_t slots = std::max(allowed.size(), static_cast<size_t>(nodes));
+        for (size_t i = 0; i < slots; ++i) {
+            t.nodes_[i % nodes].cpus.push_back(allowed[i % allowed.size()]);
+        }
+        return t;
+    }
+
+    // every allowed CPU in one node (what a program that ignores NUMA assumes)
+    static Topology flat() {
+        Topology t;
+        t.nodes_.push_back({0, usableCpus()});
+        return t;
+    }
+
+    const std::vector<NumaNode>& nodes() const { return nodes_; }
+    size_t nodeCount() const { return nodes_.size(); }
+    bool isSimulated() const { return simulated_; }
+
+    // distance between the nodes of index `from` and `to`; 10 (local) and 20 (remote), the kernel's defaults,
+    // when sysfs does not say (flat and simulated topologies)
+    int distance(size_t from, size_t to) const {
+        const std::vector<int>& d = nodes_[from].distance;
+        size_t id = static_cast<size_t>(nodes_[to].id);
+        if (id < d.size() && d[id] > 0) {
+            return d[id];
+        }
+        return from == to ? 10 : 20;
+    }
+
+    size_t cpuCount() const {
+        size_t n = 0;
+        for (const auto& node : nodes_) {
+            n += node.cpus.size();
+        }
+        return n;
+    }
+};
+
+// NumaTaskPool: one worker per CPU of the topology, one task queue per node.
+// A worker takes tasks from its own node's queue first, and only steals from the other nodes when its queue
+// is empty, so a task posted to the node that holds its data runs next to that data. It steals from the
+// nearest nodes first (Topology::distance); nodes at the same distance are tried in ring order from its own.
+class NumaTaskPool {
+public:
+    enum class Placement {
+        pinPerCore, // each worker pinned to its CPU
+        pinPerNode, // each worker may run on any CPU of its node
+        unpinned,   // the scheduler decides (the workers of 0x19-packaged_task_real_example.cpp)
+    };
+
+private:
+    struct NodeQueue {
+        std::mutex mtx;
+        std::deque<Task> tasks;
+    };
+
+    Topology topo_;
+    std::vector<std::unique_ptr<NodeQueue>> queues_;
+    std::vector<std::vector<size_t>> victims_; // per node: the other nodes, nearest first
+    std::atomic<size_t> pending_{0};           // never less than the number of queued tasks
+    std::atomic<size_t> sleepers_{0};
+    std::atomic<size_t> localRuns_{0};
+    std::atomic<size_t> stolenRuns_{0};
+    std::mutex sleepMtx_;
+    std::condition_variable_any wakeCv_;
+    ThreadGroup workers_; // last: stopped and joined before the queues are destroyed
+
+    bool tryPop(size_t node, Task& out) {
+        NodeQueue& q = *queues_[node];
+        std::lock_guard<std::mutex> lock(q.mtx);
+        if (q.tasks.empty()) {
+            return false;
+        }
+        out = std::move(q.tasks.front());
+        q.tasks.pop_front();
+        pending_.fetch_sub(1);
+        return true;
+    }
+
+    void workerLoop(std::stop_token token, size_t node) {
+        Task task;
+        while (!token.stop_requested()) {
+            if (tryPop(node, task)) {
+                localRuns_.fetch_add(1, std::memory_order_relaxed);
+                task();
+                continue;
+            }
+            bool stole = false;
+            for (size_t i = 0; i < victims_[node].size() && !stole; ++i) {
+                stole = tryPop(victims_[node][i], task);
+            }
+            if (stole) {
+                stolenRuns_.fetch_add(1, std::memory_order_relaxed);
+                task();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMtx_);
+            sleepers_.fetch_add(1);
+            wakeCv_.wait(lock, token, [this] { return pending_.load() > 0; });
+            sleepers_.fetch_sub(1);
+        }
+    }
+
+public:
+    explicit NumaTaskPool(Topology topo, Placement placement = Placement::pinPerCore) : topo_(std::move(topo)) {
+        size_t count = topo_.nodeCount();
+        for (size_t n = 0; n < count; ++n) {
+            queues_.push_back(std::make_unique<NodeQueue>());
+            std::vector<size_t> victims;
+            for (size_t d = 1; d < count; ++d) {
+                victims.push_back((n + d) % count); // ring order: the tie-break of the stable sort
+            }
+            std::stable_sort(victims.begin(), victims.end(), [this, n](size_t a, size_t b) {
+                return topo_.distance(n, a) < topo_.distance(n, b);
+            });
+            victims_.push_back(std::move(victims));
+        }
+        for (size_t n = 0; n < topo_.nodeCount(); ++n) {
+            const NumaNode& node = topo_.nodes()[n];
+            for (int cpu : node.cpus) {
+                ThreadOptions options{"node" + std::to_string(node.id) + "-cpu" + std::to_string(cpu), {}};
+                if (placement == Placement::pinPerCore) {
+                    options.cpus = {cpu};
+                } else if (placement == Placement::pinPerNode) {
+                    options.cpus = node.cpus;
+                }
+                workers_.spawn(std::move(options), [this, n](std::stop_token token) { workerLoop(token, n); });
+            }
+        }
+    }
+
+    // stops the workers once their current task is done; tasks still queued are dropped
+    ~NumaTaskPool() {
+        workers_.requestStop(); // also wakes the sleeping workers (condition_variable_any + stop_token)
+    }
+
+    NumaTaskPool(const NumaTaskPool&) = delete;
+    NumaTaskPool& operator=(const NumaTaskPool&) = delete;
+
+    // queues `t` on node index `node` (0 .. nodeCount()-1)
+    void post(size_t node, Task t) {
+        NodeQueue& q = *queues_.at(node);
+        {
+            std::lock_guard<std::mutex> lock(q.mtx);
+            // counted before the task is visible: a worker can not pop it (and decrement) first, so the
+            // counter never wraps below zero
+            pending_.fetch_add(1); // seq_cst, pairs with sleepers_ in workerLoop
+            q.tasks.push_back(std::move(t));
+        }
+        if (sleepers_.load() > 0) {
+            std::lock_guard<std::mutex> lock(sleepMtx_); // a worker between its check and its wait sees it
+            wakeCv_.notify_one();
+        }
+    }
+
+    const Topology& topology() const { return topo_; }
+    size_t localRuns() const { return localRuns_.load(); }
+    size_t stolenRuns() const { return stolenRuns_.load(); }
+};
+
+#endif // NUMA_TOPOLOGY_HPP
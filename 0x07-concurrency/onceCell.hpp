@@ -0,0 +1,116 @@
+#ifndef ONCE_CELL_HPP
+#define ONCE_CELL_HPP
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+// OnceCell<T>: a value that is initialized at most once, on first use, by whichever thread gets there first.
+// 0x11-lazy_initialization.cpp uses std::call_once for that, which (in libstdc++) goes through pthread_once
+// and a thread-local callable on every call, even long after the initialization is done.
+// Here the fast path, once the value exists, is a single acquire load of a flag.
+// The slow path (first use) takes a mutex, so only one thread runs the initializer.
+//
+// If the initializer throws (or returns an empty optional in tryGetOrInit) the cell stays empty,
+// and the next call tries again.
+template <typename T>
+class OnceCell {
+private:
+    std::atomic<bool> ready_{false};
+    std::mutex mtx_;
+    alignas(T) unsigned char storage_[sizeof(T)];
+
+    T* ptr() noexcept { return std::launder(reinterpret_cast<T*>(storage_)); }
+
+    template <typename Fn>
+    T* initSlow(Fn& init) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (!ready_.load(std::memory_order_relaxed)) { // another thread may have done it while we waited
+            std::optional<T> value = init();
+            if (!value) {
+                return nullptr; // failed, the next caller will retry
+            }
+            ::new (static_cast<void*>(storage_)) T(std::move(*value));
+            ready_.store(true, std::memory_order_release); // publishes the value
+        }
+        return ptr();
+    }
+
+public:
+    OnceCell() noexcept = default;
+    ~OnceCell() {
+        if (ready_.load(std::memory_order_acquire)) {
+            ptr()->~T();
+        }
+    }
+
+    OnceCell(const OnceCell&) = delete;
+    OnceCell& operator=(const OnceCell&) = delete;
+
+    bool isInitialized() const noexcept { return ready_.load(std::memory_order_acquire); }
+
+    // nullptr if the value does not exist yet
+    T* tryGet() noexcept {
+        return ready_.load(std::memory_order_acquire) ? ptr() : nullptr;
+    }
+
+    // `init` returns a T; an exception thrown by `init` is propagated and the cell stays empty
+    template <typename Fn>
+    T& getOrInit(Fn&& init) {
+        if (ready_.load(std::memory_order_acquire)) { // fast path
+            return *ptr();
+        }
+        auto wrapped = [&init]() { return std::optional<T>(init()); };
+        return *initSlow(wrapped);
+    }
+
+    // fallible initialization: `init` returns std::optional<T>; nullptr means it failed this time
+    template <typename Fn>
+    T* tryGetOrInit(Fn&& init) {
+        if (ready_.load(std::memory_order_acquire)) {
+            return ptr();
+        }
+        return initSlow(init);
+    }
+};
+
+// Lazy<T, Init>: a OnceCell that knows its initializer. T and Init are deduced from the initializer:
+//     Lazy config([] { return loadConfig(); }); // Lazy<Config, the lambda's type>
+//     config->value ... // loaded on first use
+template <typename T, typename Init>
+class Lazy {
+private:
+    OnceCell<T> cell_;
+    Init init_;
+
+public:
+    explicit Lazy(Init init) : init_(std::move(init)) {}
+
+    T& get() { return cell_.getOrInit(init_); }
+    T& operator*() { return get(); }
+    T* operator->() { return &get(); }
+    bool isInitialized() const noexcept { return cell_.isInitialized(); }
+};
+
+template <typename Init>
+Lazy(Init) -> Lazy<std::remove_cvref_t<std::invoke_result_t<Init&>>, Init>;
+
+// Thread-local cached access to a Lazy with static storage duration:
+// after its first call, each thread reads a plain thread_local pointer (no atomic at all).
+//     static Lazy config(loadConfig);
+//     Config& c = threadCached<config>();
+template <auto& lazy>
+auto& threadCached() {
+    using Value = std::remove_reference_t<decltype(lazy.get())>;
+    thread_local Value* cached = nullptr;
+    if (!cached) {
+        cached = &lazy.get();
+    }
+    return *cached;
+}
+
+#endif // ONCE_CELL_HPP
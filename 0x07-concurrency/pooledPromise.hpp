@@ -0,0 +1,229 @@
+#ifndef POOLED_PROMISE_HPP
+#define POOLED_PROMISE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// PooledPromise<T> / PooledFuture<T>: a one-shot promise/future pair like std::promise/std::future, but the
+// shared state comes from a SharedStatePool<T> instead of a new heap allocation per pair.
+// * the pool hands out states from a free list and allocates them in blocks, so after warm-up a pair costs no
+//   allocation at all; a state goes back to the list when both the promise and the future are gone;
+// * the state is just the value slot, a ready flag and a reference count: get() waits with
+//   std::atomic::wait (a futex on Linux), there is no mutex or condition variable in it;
+// * a promise destroyed without a value sets std::future_errc::broken_promise, as std::promise does.
+// The pool must outlive every promise and future made from it.
+
+template <typename T>
+class SharedStatePool;
+
+namespace detail {
+
+template <typename T>
+struct PooledState {
+    using Stored = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+    std::optional<Stored> value;
+    std::exception_ptr error;
+    std::atomic<bool> ready{false};
+    std::atomic<int> refs{0}; // promise + future
+    SharedStatePool<T>* pool = nullptr;
+    PooledState* nextFree = nullptr;
+};
+
+} // namespace detail
+
+template <typename T>
+class SharedStatePool {
+private:
+    using State = detail::PooledState<T>;
+    std::vector<std::unique_ptr<State[]>> blocks_;
+    State* free_ = nullptr;
+    const size_t blockSize_;
+    size_t capacity_ = 0;
+    std::mutex mtx_;
+
+public:
+    explicit SharedStatePool(size_t blockSize = 256) : blockSize_(blockSize > 0 ? blockSize : 1) {}
+
+    SharedStatePool(const SharedStatePool&) = delete;
+    SharedStatePool& operator=(const SharedStatePool&) = delete;
+
+    State* acquire() {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (!free_) {
+            blocks_.push_back(std::make_unique<State[]>(blockSize_));
+            State* block = blocks_.back().get();
+            for (size_t i = 0; i < blockSize_; ++i) {
+                block[i].pool = this;
+                block[i].nextFree = free_;
+                free_ = &block[i];
+            }
+            capacity_ += blockSize_;
+        }
+        State* s = free_;
+        free_ = s->nextFree;
+        s->refs.store(2, std::memory_order_relaxed);
+        return s;
+    }
+
+    // called by the last owner of `s`
+    void release(State* s) noexcept {
+        s->value.reset();
+        s->error = nullptr;
+        s->ready.store(false, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(mtx_);
+        s->nextFree = free_;
+        free_ = s;
+    }
+
+    // states allocated so far (in use or free)
+    size_t capacity() {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return capacity_;
+    }
+};
+
+namespace detail {
+
+template <typename T>
+void dropRef(PooledState<T>* s) noexcept {
+    if (s && s->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        s->pool->release(s);
+    }
+}
+
+} // namespace detail
+
+template <typename T>
+class PooledFuture {
+private:
+    template <typename>
+    friend class PooledPromise;
+    detail::PooledState<T>* state_ = nullptr;
+    explicit PooledFuture(detail::PooledState<T>* s) : state_(s) {}
+
+public:
+    PooledFuture() = default;
+    PooledFuture(PooledFuture&& other) noexcept : state_(std::exchange(other.state_, nullptr)) {}
+    PooledFuture& operator=(PooledFuture&& other) noexcept {
+        if (this != &other) {
+            detail::dropRef(state_);
+            state_ = std::exchange(other.state_, nullptr);
+        }
+        return *this;
+    }
+    ~PooledFuture() { detail::dropRef(state_); }
+
+    bool valid() const noexcept { return state_ != nullptr; }
+
+    bool isReady() const { return state_ && state_->ready.load(std::memory_order_acquire); }
+
+    void wait() const {
+        if (!state_) {
+            throw std::future_error(std::future_errc::no_state);
+        }
+        state_->ready.wait(false, std::memory_order_acquire);
+    }
+
+    // waits, then returns the value (or rethrows the exception); the future is empty afterwards
+    T get() {
+        wait();
+        detail::PooledState<T>* s = std::exchange(state_, nullptr);
+        struct Release { // gives the state back even if we throw
+            detail::PooledState<T>* s;
+            ~Release() { detail::dropRef(s); }
+        } release{s};
+        if (s->error) {
+            std::rethrow_exception(s->error);
+        }
+        if constexpr (!std::is_void_v<T>) {
+            return std::move(*s->value);
+        }
+    }
+};
+
+template <typename T>
+class PooledPromise {
+private:
+    detail::PooledState<T>* state_ = nullptr;
+    bool futureTaken_ = false;
+
+    void publish() {
+        state_->ready.store(true, std::memory_order_release);
+        state_->ready.notify_one();
+    }
+
+    void checkState() const {
+        if (!state_) {
+            throw std::future_error(std::future_errc::no_state);
+        }
+        if (state_->ready.load(std::memory_order_relaxed)) {
+            throw std::future_error(std::future_errc::promise_already_satisfied);
+        }
+    }
+
+    // breaks the promise if it was not kept, then lets go of the state
+    void abandon() noexcept {
+        if (!state_) {
+            return;
+        }
+        if (!state_->ready.load(std::memory_order_relaxed)) {
+            state_->error = std::make_exception_ptr(std::future_error(std::future_errc::broken_promise));
+            publish();
+        }
+        if (!futureTaken_) {
+            detail::dropRef(state_); // the future's reference, nobody will ever use it
+        }
+        detail::dropRef(std::exchange(state_, nullptr));
+    }
+
+public:
+    PooledPromise() = default;
+    explicit PooledPromise(SharedStatePool<T>& pool) : state_(pool.acquire()) {}
+
+    PooledPromise(PooledPromise&& other) noexcept
+        : state_(std::exchange(other.state_, nullptr)), futureTaken_(other.futureTaken_) {}
+    PooledPromise& operator=(PooledPromise&& other) noexcept {
+        if (this != &other) {
+            abandon();
+            state_ = std::exchange(other.state_, nullptr);
+            futureTaken_ = other.futureTaken_;
+        }
+        return *this;
+    }
+    ~PooledPromise() { abandon(); }
+
+    PooledFuture<T> get_future() {
+        if (!state_) {
+            throw std::future_error(std::future_errc::no_state);
+        }
+        if (futureTaken_) {
+            throw std::future_error(std::future_errc::future_already_retrieved);
+        }
+        futureTaken_ = true;
+        return PooledFuture<T>(state_);
+    }
+
+    template <typename... V>
+    void set_value(V&&... v) {
+        checkState();
+        state_->value.emplace(std::forward<V>(v)...);
+        publish();
+    }
+
+    void set_exception(std::exception_ptr e) {
+        checkState();
+        state_->error = std::move(e);
+        publish();
+    }
+};
+
+#endif // POOLED_PROMISE_HPP
@@ -0,0 +1,42 @@
+#ifndef PROCESS_STATS_HPP
+#define PROCESS_STATS_HPP
+
+#include <cerrno>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <system_error>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Helpers for the examples that compare the memory footprint of two ways of doing the same work
+// (0x14-future_async_promise/0x05-pooled_async.cpp, 0x1D-coroutine_queries.cpp).
+
+// the peak resident set size of this process so far, in KB
+inline long peakRssKb() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// runs `fn` in a child process, so every benchmark starts from the same (small) memory footprint
+inline void inChildProcess(const std::function<void()>& fn) {
+    pid_t pid = fork();
+    if (pid < 0) {
+        throw std::system_error(errno, std::generic_category(), "fork");
+    }
+    if (pid == 0) {
+        try {
+            fn();
+        } catch (const std::exception& e) {
+            std::cerr << "Exception: " << e.what() << std::endl;
+            _exit(1);
+        }
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+}
+
+#endif // PROCESS_STATS_HPP
@@ -0,0 +1,148 @@
+#!/usr/bin/env bash
+# race_check.sh: runs the multithreaded examples under ThreadSanitizer and under a randomized schedule.
+# Every program is built as it is (its own main) and run with small arguments and a time limit, so one that
+# never exits (0x19's worker_thread loops forever) is reported instead of hanging the check.
+# * tsan:   g++ -fsanitize=thread; a data race report (or any other TSan report) fails the run;
+# * stress: a normal build run several times with yieldInjector.cpp preloaded, which yields or sleeps at random
+#           around every mutex and condition variable call; a crash, a wrong exit code or a hang fails the run.
+#           (An example expected to hang runs once: no schedule makes it exit.)
+# Some examples are wrong on purpose (they show what a race or a deadlock looks like). The table below says
+# what each one is expected to do, and the check only fails on a difference: a race that disappears from a
+# "race" example is reported too, so the table stays true.
+# usage: ./race_check.sh [tsan|stress|all] [name_filter]
+#        RUNS=5 TIMEOUT=60 CXX=g++ ./race_check.sh stress 0x1B
+set -u
+
+cd "$(dirname "$0")"
+MODE=${1:-all}
+FILTER=${2:-}
+CXX=${CXX:-g++}
+TIMEOUT=${TIMEOUT:-60}
+RUNS=${RUNS:-5}
+OUT=$(mkdir -p "${OUT:-/tmp/race_check}" && cd "${OUT:-/tmp/race_check}" && pwd)
+SP=../0x06-smart_pointers/smart_pointers_with_multithreading
+
+# source | arguments for a short run | expected: ok, race (TSan reports, the program is wrong on purpose),
+#     hang (never exits on its own), abort (std::terminate, e.g. a std::thread destroyed without join())
+# 0x0A's threads share std::cout without a lock: the output is garbled, but every stream operation is
+# synchronized inside the library, so there is no data race for TSan to report.
+PROGRAMS="
+0x00-thread.cpp||ok
+0x01-thread.cpp||abort
+0x02-thread.cpp||ok
+0x03-thread.cpp||ok
+0x04-thread.cpp||ok
+0x05-thread.cpp||race
+0x06-thread.cpp||ok
+0x0A-thread_data_race.cpp||ok
+0x0B-thread_mutex.cpp||ok
+0x0D-deadlock.cpp||ok
+0x10-unique_lock.cpp||ok
+0x11-lazy_initialization.cpp||ok
+0x13-condition_variables.cpp||ok
+0x15-callable_objects.cpp||abort
+0x16-packaged_task.cpp||hang
+0x17-packaged_task.cpp||abort
+0x18-packaged_task.cpp||ok
+0x19-packaged_task_real_example.cpp||hang
+0x1A-once_cell.cpp|4 1000|ok
+0x1B-bounded_buffer.cpp|2000 64|ok
+0x1C-futex_primitives.cpp|2000|ok
+0x1D-coroutine_queries.cpp|200 20 2|ok
+0x1E-timer_wheel.cpp|10000 1000|ok
+0x1F-thread_group.cpp|50|ok
+0x20-numa_workers.cpp|2 4 2|ok
+0x21-deadline_scheduler.cpp|20 60 2 10|ok
+0x22-unique_function.cpp|5000|ok
+0x23-big_factorial.cpp|10000 4|ok
+0x14-future_async_promise/0x00-example.cpp||ok
+0x14-future_async_promise/0x01-example.cpp||ok
+0x14-future_async_promise/0x02-example.cpp||ok
+0x14-future_async_promise/0x03-example.cpp||ok
+0x14-future_async_promise/0x04-future_then.cpp|100|ok
+0x14-future_async_promise/0x05-pooled_async.cpp|2000 64|ok
+$SP/0x00-single_thread.cpp||ok
+$SP/0x01-muti_threading.cpp||ok
+$SP/0x02-multi_threading.cpp||race
+$SP/0x03-circular_ref.cpp||ok
+$SP/0x04-custom_deleter.cpp||ok
+$SP/0x05-snapshot_cell.cpp|2 200|ok
+$SP/0x06-weak_cache.cpp|4 100|ok
+"
+
+failures=0
+
+# prints ok, race, hang, abort or crash(<code>) for one run of "$@" (in $OUT: some examples write files)
+classify() {
+    local log=$1
+    shift
+    (cd "$OUT" && timeout --signal=KILL "$TIMEOUT" "$@") >"$log" 2>&1
+    local code=$?
+    if grep -q "WARNING: ThreadSanitizer" "$log"; then
+        echo race
+    elif [ $code -eq 137 ]; then
+        echo hang
+    elif [ $code -eq 134 ]; then
+        echo abort
+    elif [ $code -ne 0 ]; then
+        echo "crash($code)"
+    else
+        echo ok
+    fi
+}
+
+report() { # name mode expected actual log
+    if [ "$4" = "$3" ]; then
+        printf '%-48s %-7s %-10s\n' "$1" "$2" "$4"
+    else
+        printf '%-48s %-7s %-10s expected %s, see %s\n' "$1" "$2" "$4" "$3" "$5"
+        failures=$((failures + 1))
+    fi
+}
+
+if [ "$MODE" = stress ] || [ "$MODE" = all ]; then
+    "$CXX" -O2 -shared -fPIC yieldInjector.cpp -o "$OUT/libyieldinjector.so" -ldl || exit 1
+fi
+
+while IFS='|' read -r src args expected; do
+    [ -z "$src" ] && continue
+    case "$src" in *"$FILTER"*) ;; *) continue ;; esac
+    name=$(basename "${src%.cpp}")
+    dir=$(dirname "$src")
+
+    if [ "$MODE" = tsan ] || [ "$MODE" = all ]; then
+        bin="$OUT/$name.tsan"
+        supp="$(pwd)/tsan.supp"
+        if ! "$CXX" -std=c++20 -O1 -g -fsanitize=thread -pthread -I"$dir" "$src" -o "$bin" 2>"$OUT/$name.build.log"; then
+            report "$src" tsan "$expected" build "$OUT/$name.build.log"
+        else
+            # exitcode=0: the TSan report itself is what we look for, not the exit code it would force
+            actual=$(TSAN_OPTIONS="exitcode=0 report_signal_unsafe=0 suppressions=$supp" classify "$OUT/$name.tsan.log" "$bin" $args)
+            report "$src" tsan "$expected" "$actual" "$OUT/$name.tsan.log"
+        fi
+    fi
+
+    if [ "$MODE" = stress ] || [ "$MODE" = all ]; then
+        bin="$OUT/$name.stress"
+        if ! "$CXX" -std=c++20 -O1 -g -pthread -I"$dir" "$src" -o "$bin" 2>"$OUT/$name.build.log"; then
+            report "$src" stress "$expected" build "$OUT/$name.build.log"
+            continue
+        fi
+        # a race is not visible without TSan: an example that is racy on purpose only has to finish
+        want=$expected
+        [ "$want" = race ] && want=ok
+        # a program that never exits hangs whatever the schedule: one run (of TIMEOUT seconds) says it all
+        runs=$RUNS
+        [ "$want" = hang ] && runs=1
+        actual=ok
+        for seed in $(seq 1 "$runs"); do
+            actual=$(YIELD_SEED=$seed LD_PRELOAD="$OUT/libyieldinjector.so" \
+                classify "$OUT/$name.stress.log" "$bin" $args)
+            [ "$actual" != "$want" ] && break
+        done
+        report "$src" stress "$want" "$actual" "$OUT/$name.stress.log"
+    fi
+done <<<"$PROGRAMS"
+
+echo "unexpected results: $failures"
+[ $failures -eq 0 ]
@@ -0,0 +1,336 @@
+#ifndef SCOPED_TIMER_HPP
+#define SCOPED_TIMER_HPP
+
+// Hot-path instrumentation: SCOPED_TIMER("name") at the top of a scope records how long the scope took into a
+// latency histogram of the calling thread, and INSTRUMENT_REPORT(os) merges the histograms of all threads and
+// prints count, mean, percentiles and max per name. Nothing is printed unless asked for, and
+// INSTRUMENT_PERIODIC_REPORT(os, interval) does the same from a background thread every `interval` (for a
+// program that never exits, like 0x19).
+// * the clock is rdtsc on x86 (about 20 cycles, no system call) and steady_clock elsewhere or with
+//   -DINSTRUMENT_STEADY_CLOCK. Ticks are converted to ns when the report is made, from the ticks and the
+//   steady_clock time elapsed since the first timer, so there is no calibration loop at start-up (this assumes
+//   an invariant TSC, which every x86 CPU of the last 15 years has);
+// * the histograms are HDR-style (log-linear): 32 linear sub-buckets per power of two, so a value is reported
+//   within 1/32 (3%) of what was measured, from 1 tick to 2^64 in 15 KB;
+// * every thread records into its own histograms, without a lock and without a shared cache line. The reporter
+//   reads them while they are written (the counters are relaxed atomics with a single writer); a thread that
+//   exits folds its histograms into a retired total, so its numbers stay in the report.
+// Without -DMODERN_CPP_INSTRUMENT (cmake -DMODERN_CPP_INSTRUMENT=ON, or the preset "instrument") the macros
+// expand to nothing and this header includes nothing: the instrumented code is the same as if they were not
+// there.
+
+#ifdef MODERN_CPP_INSTRUMENT
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(INSTRUMENT_STEADY_CLOCK)
+#include <x86intrin.h>
+#define INSTRUMENT_USE_RDTSC 1
+#endif
+
+namespace instrument {
+
+inline uint64_t ticks() {
+#ifdef INSTRUMENT_USE_RDTSC
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// the merged (plain) copy of one or more histograms
+struct Snapshot {
+    std::vector<uint64_t> counts;
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint64_t max = 0;
+    size_t threads = 0;
+
+    // value at quantile q (0..1): the highest value of the bucket that holds it, never above max
+    uint64_t quantile(double q) const;
+};
+
+class Histogram {
+public:
+    static constexpr unsigned subBucketBits = 5;
+    static constexpr uint64_t subBuckets = uint64_t(1) << subBucketBits;
+    static constexpr size_t bucketCount = (64 - subBucketBits + 1) * subBuckets;
+
+    // values below subBuckets have a bucket each; above, the bucket is (power of two, top subBucketBits bits)
+    static size_t indexOf(uint64_t v) {
+        if (v < subBuckets) {
+            return static_cast<size_t>(v);
+        }
+        unsigned e = static_cast<unsigned>(std::bit_width(v)) - 1;
+        uint64_t mantissa = v >> (e - subBucketBits); // in [subBuckets, 2 * subBuckets)
+        return (e - subBucketBits + 1) * subBuckets + static_cast<size_t>(mantissa - subBuckets);
+    }
+
+    static uint64_t highestEquivalent(size_t index) {
+        if (index < subBuckets) {
+            return index;
+        }
+        unsigned e = static_cast<unsigned>(index / subBuckets) - 1 + subBucketBits;
+        uint64_t mantissa = index % subBuckets + subBuckets;
+        unsigned shift = e - subBucketBits;
+        return ((mantissa + 1) << shift) - 1;
+    }
+
+    // only the owning thread records: a load and a store are enough, no read-modify-write
+    void record(uint64_t v) {
+        bump(counts_[indexOf(v)], 1);
+        bump(count_, 1);
+        bump(sum_, v);
+        if (v > max_.load(std::memory_order_relaxed)) {
+            max_.store(v, std::memory_order_relaxed);
+        }
+    }
+
+    void addTo(Snapshot& s) const {
+        if (s.counts.empty()) {
+            s.counts.resize(bucketCount);
+        }
+        for (size_t i = 0; i < bucketCount; ++i) {
+            s.counts[i] += counts_[i].load(std::memory_order_relaxed);
+        }
+        s.count += count_.load(std::memory_order_relaxed);
+        s.sum += sum_.load(std::memory_order_relaxed);
+        s.max = std::max(s.max, max_.load(std::memory_order_relaxed));
+    }
+
+private:
+    static void bump(std::atomic<uint64_t>& a, uint64_t by) {
+        a.store(a.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+
+    std::atomic<uint64_t> counts_[bucketCount] = {};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+inline uint64_t Snapshot::quantile(double q) const {
+    if (count == 0) {
+        return 0;
+    }
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(q * static_cast<double>(count) + 0.5));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return std::min(Histogram::highestEquivalent(i), max);
+        }
+    }
+    return max;
+}
+
+// the histograms of one thread, indexed by site id
+struct ThreadState {
+    std::vector<std::unique_ptr<Histogram>> bySite;
+    ThreadState();
+    ~ThreadState();
+};
+
+// the names, the histograms of the live threads and the totals of the threads that exited. Leaked on purpose:
+// a thread (or a PeriodicReport) may still use it while the static objects are destroyed
+class Registry {
+private:
+    std::mutex mtx;
+    std::map<std::string, size_t> ids;
+    std::vector<std::string> names;
+    std::vector<ThreadState*> live;
+    std::vector<Snapshot> retired;      // by site id
+    std::vector<size_t> retiredThreads; // by site id
+    uint64_t startTicks = ticks();
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    Registry() = default;
+
+public:
+    static Registry& instance() {
+        static Registry* registry = new Registry;
+        return *registry;
+    }
+
+    // one id per name: two SCOPED_TIMER with the same name share it
+    size_t site(const char* name) {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto [it, inserted] = ids.try_emplace(name, names.size());
+        if (inserted) {
+            names.emplace_back(name);
+            retired.emplace_back();
+            retiredThreads.push_back(0);
+        }
+        return it->second;
+    }
+
+    // the first time a thread hits a site (under the lock: the reporter may be reading bySite)
+    Histogram& grow(ThreadState& t, size_t id) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (t.bySite.size() <= id) {
+            t.bySite.resize(id + 1);
+        }
+        if (!t.bySite[id]) {
+            t.bySite[id] = std::make_unique<Histogram>();
+        }
+        return *t.bySite[id];
+    }
+
+    void attach(ThreadState* t) {
+        std::lock_guard<std::mutex> lock(mtx);
+        live.push_back(t);
+    }
+
+    void retire(ThreadState* t) {
+        std::lock_guard<std::mutex> lock(mtx);
+        for (size_t id = 0; id < t->bySite.size(); ++id) {
+            if (t->bySite[id]) {
+                t->bySite[id]->addTo(retired[id]);
+                ++retiredThreads[id];
+            }
+        }
+        live.erase(std::remove(live.begin(), live.end(), t), live.end());
+    }
+
+    // every name with the histograms of all threads merged, in ticks
+    std::map<std::string, Snapshot> merge() {
+        std::lock_guard<std::mutex> lock(mtx);
+        std::map<std::string, Snapshot> out;
+        for (size_t id = 0; id < names.size(); ++id) {
+            Snapshot s = retired[id];
+            s.threads = retiredThreads[id];
+            for (ThreadState* t : live) {
+                if (id < t->bySite.size() && t->bySite[id]) {
+                    t->bySite[id]->addTo(s);
+                    ++s.threads;
+                }
+            }
+            if (s.count > 0) {
+                out.emplace(names[id], std::move(s));
+            }
+        }
+        return out;
+    }
+
+    double nsPerTick() {
+#ifdef INSTRUMENT_USE_RDTSC
+        // a few ms at least, or the ratio is mostly the noise of the two clock reads
+        if (std::chrono::steady_clock::now() - startTime < std::chrono::milliseconds(10)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - startTime).count();
+        return ns / static_cast<double>(ticks() - startTicks);
+#else
+        return 1.0;
+#endif
+    }
+};
+
+inline ThreadState::ThreadState() {
+    Registry::instance().attach(this);
+}
+
+inline ThreadState::~ThreadState() {
+    Registry::instance().retire(this);
+}
+
+inline Histogram& threadHistogram(size_t id) {
+    thread_local ThreadState state;
+    if (id < state.bySite.size() && state.bySite[id]) {
+        return *state.bySite[id];
+    }
+    return Registry::instance().grow(state, id);
+}
+
+class ScopedTimer {
+private:
+    Histogram& histogram;
+    uint64_t start;
+
+public:
+    explicit ScopedTimer(Histogram& h) : histogram(h), start(ticks()) {}
+    ~ScopedTimer() { histogram.record(ticks() - start); }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+};
+
+inline void report(std::ostream& os) {
+    Registry& registry = Registry::instance();
+    double scale = registry.nsPerTick();
+    auto merged = registry.merge();
+    auto ns = [scale](double ticks) { return ticks * scale; };
+    std::ostringstream out; // one write, so a periodic report does not interleave with the program's output
+    out << std::left << std::setw(32) << "timer (ns)" << std::right << std::setw(8) << "threads" << std::setw(12)
+        << "count" << std::setw(11) << "mean" << std::setw(11) << "p50" << std::setw(11) << "p90" << std::setw(11)
+        << "p99" << std::setw(11) << "p99.9" << std::setw(11) << "max" << "\n"
+        << std::fixed << std::setprecision(0);
+    for (const auto& [name, s] : merged) {
+        out << std::left << std::setw(32) << name << std::right << std::setw(8) << s.threads << std::setw(12)
+            << s.count << std::setw(11) << ns(static_cast<double>(s.sum) / static_cast<double>(s.count))
+            << std::setw(11) << ns(s.quantile(0.5)) << std::setw(11) << ns(s.quantile(0.9)) << std::setw(11)
+            << ns(s.quantile(0.99)) << std::setw(11) << ns(s.quantile(0.999)) << std::setw(11) << ns(s.max) << "\n";
+    }
+    os << out.str() << std::flush;
+}
+
+// report(os) every `interval` from a background thread, until destroyed
+class PeriodicReport {
+private:
+    std::mutex mtx;
+    std::condition_variable_any cv;
+    std::jthread thread;
+
+public:
+    PeriodicReport(std::ostream& os, std::chrono::milliseconds interval)
+        : thread([this, &os, interval](std::stop_token stop) {
+              auto start = std::chrono::steady_clock::now();
+              std::unique_lock<std::mutex> lock(mtx);
+              while (true) {
+                  // nothing notifies cv: this only returns on timeout or when the destructor requests stop
+                  cv.wait_for(lock, stop, interval, [] { return false; });
+                  if (stop.stop_requested()) {
+                      return;
+                  }
+                  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+                  os << "[instrument] after " << elapsed.count() << " ms:\n";
+                  report(os);
+              }
+          }) {}
+};
+
+} // namespace instrument
+
+#define INSTRUMENT_CONCAT2(a, b) a##b
+#define INSTRUMENT_CONCAT(a, b) INSTRUMENT_CONCAT2(a, b)
+#define SCOPED_TIMER(name)                                                                                       \
+    static const size_t INSTRUMENT_CONCAT(instrumentSite_, __LINE__) = ::instrument::Registry::instance().site(name); \
+    ::instrument::ScopedTimer INSTRUMENT_CONCAT(instrumentTimer_, __LINE__)(                                     \
+        ::instrument::threadHistogram(INSTRUMENT_CONCAT(instrumentSite_, __LINE__)))
+#define INSTRUMENT_REPORT(os) ::instrument::report(os)
+#define INSTRUMENT_PERIODIC_REPORT(os, interval) \
+    ::instrument::PeriodicReport INSTRUMENT_CONCAT(instrumentReport_, __LINE__)((os), (interval))
+
+#else // !MODERN_CPP_INSTRUMENT
+
+#define SCOPED_TIMER(name) static_cast<void>(0)
+#define INSTRUMENT_REPORT(os) static_cast<void>(0)
+#define INSTRUMENT_PERIODIC_REPORT(os, interval) static_cast<void>(0)
+
+#endif // MODERN_CPP_INSTRUMENT
+
+#endif // SCOPED_TIMER_HPP
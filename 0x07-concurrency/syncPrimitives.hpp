@@ -0,0 +1,167 @@
+#ifndef SYNC_PRIMITIVES_HPP
+#define SYNC_PRIMITIVES_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+// Lightweight Event, CountingSemaphore and Latch.
+// When the shared state is a single flag or a counter, std::condition_variable + std::mutex is more than needed:
+// C++20 std::atomic<T>::wait/notify lets a thread sleep until the atomic changes (a futex on Linux),
+// without any mutex.
+// Every wait first spins for a short time, because the other thread often answers within a few hundred
+// nanoseconds, and parking/unparking a thread costs a few microseconds. On a single core machine spinning
+// can only delay the thread we are waiting for, so the default spin count is 0 there.
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+inline int defaultSpinCount() {
+    static const int spins = std::thread::hardware_concurrency() > 1 ? 200 : 0;
+    return spins;
+}
+
+// spins until pred() is true or the spin budget is spent; returns pred()
+template <typename Pred>
+bool spinUntil(int spins, Pred pred) {
+    for (int i = 0; i < spins; ++i) {
+        if (pred()) {
+            return true;
+        }
+        cpuRelax();
+    }
+    return pred();
+}
+
+// Manual-reset event: wait() returns once set() has been called, until reset().
+class Event {
+private:
+    // 0: not set, 1: set, 2: not set and somebody is (or was) sleeping on it
+    std::atomic<uint32_t> state_;
+    int spins_;
+
+public:
+    explicit Event(bool initiallySet = false, int spins = defaultSpinCount())
+        : state_(initiallySet ? 1 : 0), spins_(spins) {}
+
+    Event(const Event&) = delete;
+    Event& operator=(const Event&) = delete;
+
+    void set() {
+        if (state_.exchange(1, std::memory_order_release) == 2) {
+            state_.notify_all(); // only pay for the system call when somebody sleeps
+        }
+    }
+
+    void reset() {
+        uint32_t expected = 1;
+        state_.compare_exchange_strong(expected, 0, std::memory_order_relaxed);
+    }
+
+    bool isSet() const { return state_.load(std::memory_order_acquire) == 1; }
+
+    void wait() {
+        if (spinUntil(spins_, [this] { return isSet(); })) {
+            return;
+        }
+        while (true) {
+            uint32_t s = state_.load(std::memory_order_acquire);
+            if (s == 1) {
+                return;
+            }
+            if (s == 0 && !state_.compare_exchange_weak(s, 2, std::memory_order_acquire)) {
+                continue; // it changed, look again
+            }
+            state_.wait(2, std::memory_order_acquire); // sleeps while the state is 2
+        }
+    }
+};
+
+// Counting semaphore: release() adds permits, acquire() takes one (waiting if there is none).
+class CountingSemaphore {
+private:
+    std::atomic<int32_t> count_;
+    std::atomic<int32_t> sleepers_{0};
+    int spins_;
+
+public:
+    explicit CountingSemaphore(int32_t initial = 0, int spins = defaultSpinCount())
+        : count_(initial), spins_(spins) {}
+
+    CountingSemaphore(const CountingSemaphore&) = delete;
+    CountingSemaphore& operator=(const CountingSemaphore&) = delete;
+
+    bool try_acquire() {
+        int32_t c = count_.load(std::memory_order_relaxed);
+        while (c > 0) {
+            if (count_.compare_exchange_weak(c, c - 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void acquire() {
+        if (spinUntil(spins_, [this] { return try_acquire(); })) {
+            return;
+        }
+        while (!try_acquire()) {
+            sleepers_.fetch_add(1, std::memory_order_seq_cst);
+            count_.wait(0, std::memory_order_seq_cst); // sleeps while there is no permit (pairs with release())
+            sleepers_.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    void release(int32_t n = 1) {
+        count_.fetch_add(n, std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_seq_cst) > 0) {
+            if (n == 1) count_.notify_one(); else count_.notify_all();
+        }
+    }
+};
+
+// Single-use countdown latch: wait() returns once count_down() was called `expected` times in total.
+class Latch {
+private:
+    std::atomic<std::ptrdiff_t> count_;
+    int spins_;
+
+public:
+    explicit Latch(std::ptrdiff_t expected, int spins = defaultSpinCount()) : count_(expected), spins_(spins) {}
+
+    Latch(const Latch&) = delete;
+    Latch& operator=(const Latch&) = delete;
+
+    void count_down(std::ptrdiff_t n = 1) {
+        if (count_.fetch_sub(n, std::memory_order_release) == n) {
+            count_.notify_all();
+        }
+    }
+
+    bool try_wait() const { return count_.load(std::memory_order_acquire) == 0; }
+
+    void wait() const {
+        if (spinUntil(spins_, [this] { return try_wait(); })) {
+            return;
+        }
+        std::ptrdiff_t c;
+        while ((c = count_.load(std::memory_order_acquire)) != 0) {
+            count_.wait(c, std::memory_order_acquire);
+        }
+    }
+
+    void arrive_and_wait(std::ptrdiff_t n = 1) {
+        count_down(n);
+        wait();
+    }
+};
+
+#endif // SYNC_PRIMITIVES_HPP
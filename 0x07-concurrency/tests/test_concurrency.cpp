@@ -0,0 +1,461 @@
+// Tests for the building blocks of the thread examples: LogFile (logFile.hpp, 0x0B-thread_mutex.cpp),
+// ThreadRAII (threadRAII.hpp, 0x04-thread.cpp), Lazy (onceCell.hpp), TimerWheel (timerWheel.hpp),
+// DeadlineScheduler (deadlineScheduler.hpp), UniqueFunction and PooledPromise (uniqueFunction.hpp,
+// pooledPromise.hpp) and BigUint (bigUint.hpp). Every check is an assert: the test target is compiled without NDEBUG, whatever the build
+// type. operator new is counted, for the allocation-free claims.
+// usage: ./a.out   (writes test_concurrency_log.txt in the current directory)
+#include <cassert>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "../bigUint.hpp"
+#include "../deadlineScheduler.hpp"
+#include "../logFile.hpp"
+#include "../onceCell.hpp"
+#include "../pooledPromise.hpp"
+#include "../threadRAII.hpp"
+#include "../timerWheel.hpp"
+#include "../uniqueFunction.hpp"
+
+std::atomic<long> allocations{0};
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+// GCC sees the free() of the replaced delete inlined next to a new-expression and warns, wrongly
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+#pragma GCC diagnostic pop
+
+// every line written by several threads at once ends up in the file, whole
+void testLogFile() {
+    const std::string path = "test_concurrency_log.txt";
+    const int threads = 4;
+    const int lines = 500;
+    {
+        LogFile log(path);
+        std::vector<std::thread> writers;
+        for (int t = 0; t < threads; ++t) {
+            writers.emplace_back([&log, t] {
+                for (int i = 0; i < lines; ++i) {
+                    log.shared_print("thread " + std::to_string(t) + " line ", i);
+                }
+            });
+        }
+        for (auto& w : writers) {
+            w.join();
+        }
+    } // closes the file
+
+    std::ifstream in(path);
+    std::set<std::string> seen;
+    std::string line;
+    while (std::getline(in, line)) {
+        assert(seen.insert(line).second); // no line twice, none torn in two
+    }
+    assert(seen.size() == static_cast<size_t>(threads * lines));
+    for (int t = 0; t < threads; ++t) {
+        assert(seen.count("thread " + std::to_string(t) + " line 0"));
+        assert(seen.count("thread " + std::to_string(t) + " line " + std::to_string(lines - 1)));
+    }
+    in.close();
+    std::remove(path.c_str());
+}
+
+void testThreadRAII() {
+    // join: the destructor waits for the thread
+    std::atomic<bool> done{false};
+    {
+        ThreadRAII t(std::thread([&done] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            done = true;
+        }), ThreadRAII::DtorAction::join);
+    }
+    assert(done);
+
+    // detach: the destructor returns at once, the thread finishes on its own
+    std::atomic<bool> release{false};
+    std::atomic<bool> finished{false};
+    {
+        ThreadRAII t(std::thread([&] {
+            while (!release) {
+                std::this_thread::yield();
+            }
+            finished = true;
+        }), ThreadRAII::DtorAction::detach);
+    }
+    assert(!finished);
+    release = true;
+    while (!finished) {
+        std::this_thread::yield();
+    }
+
+    // no thread to manage
+    bool thrown = false;
+    try {
+        ThreadRAII empty(std::thread(), ThreadRAII::DtorAction::join);
+    } catch (const std::logic_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // moving: the thread is joined once, by its last owner; move assignment joins the thread it replaces
+    std::atomic<int> runs{0};
+    {
+        ThreadRAII a(std::thread([&runs] { ++runs; }), ThreadRAII::DtorAction::join);
+        ThreadRAII b(std::move(a));
+        ThreadRAII c(std::thread([&runs] { ++runs; }), ThreadRAII::DtorAction::join);
+        c = std::move(b);
+        assert(runs >= 1); // c's first thread was joined by the assignment
+    }
+    assert(runs == 2);
+}
+
+struct Config {
+    int value = 42;
+};
+Config loadConfig() { return {}; }
+const std::string& configName() {
+    static const std::string name = "config";
+    return name;
+}
+
+Lazy globalConfig(loadConfig);
+
+// the usage of onceCell.hpp's comments: T deduced from the initializer, and threadCached<> on a static Lazy
+void testLazy() {
+    int calls = 0;
+    Lazy config([&calls] {
+        ++calls;
+        return loadConfig();
+    });
+    static_assert(std::is_same_v<std::remove_reference_t<decltype(config.get())>, Config>);
+    assert(!config.isInitialized());
+    assert(config->value == 42 && (*config).value == 42 && calls == 1);
+    assert(config.isInitialized());
+
+    Lazy name(configName); // a reference is stored as a copy of the value
+    static_assert(std::is_same_v<std::remove_reference_t<decltype(name.get())>, std::string>);
+    assert(*name == "config");
+
+    std::thread other([] { assert(threadCached<globalConfig>().value == 42); });
+    other.join();
+    assert(&threadCached<globalConfig>() == &globalConfig.get());
+}
+
+// a short timer scheduled while a long one is pending: the driver sleeps until the next cascade (level 0 is
+// empty), so the wheel's current tick trails the clock; the short delay must still count from now
+void testTimerWheelDelay() {
+    using Clock = std::chrono::steady_clock;
+    InlineExecutor ex;
+    TimerWheel<InlineExecutor> wheel(ex, std::chrono::milliseconds(1));
+    wheel.start();
+    std::atomic<bool> longFired{false};
+    auto longId = wheel.schedule(std::chrono::seconds(10), [&longFired] { longFired = true; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+
+    const auto delay = std::chrono::milliseconds(100);
+    std::atomic<bool> fired{false};
+    Clock::time_point firedAt;
+    auto scheduledAt = Clock::now();
+    wheel.schedule(delay, [&] {
+        firedAt = Clock::now();
+        fired = true;
+    });
+    while (!fired) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    assert(firedAt - scheduledAt >= delay);
+    assert(!longFired && wheel.cancel(longId));
+    wheel.stop();
+}
+
+// keeps the single worker of a scheduler busy until release(), so the tasks queued meanwhile are all there
+// when it picks the next one
+class Blocker {
+private:
+    std::promise<void> started_, gate_;
+    std::future<void> done_;
+
+public:
+    explicit Blocker(DeadlineScheduler& s) {
+        done_ = s.submit(0, [this, gate = gate_.get_future()] {
+            started_.set_value();
+            gate.wait();
+        });
+        started_.get_future().wait();
+    }
+    void release() {
+        gate_.set_value();
+        done_.get();
+    }
+};
+
+// the order a single worker runs the tasks in
+struct RunOrder {
+    std::mutex mtx;
+    std::vector<std::string> names;
+    auto task(std::string name) {
+        return [this, name] {
+            std::lock_guard<std::mutex> lock(mtx);
+            names.push_back(name);
+        };
+    }
+};
+
+void testDeadlineScheduler() {
+    using Clock = DeadlineScheduler::Clock;
+    using std::chrono::hours;
+    using std::chrono::milliseconds;
+
+    // priority classes first, earliest deadline first inside a class, tasks without a deadline last
+    {
+        DeadlineScheduler s(2, 1, hours(1));
+        Blocker blocker(s);
+        RunOrder order;
+        auto now = Clock::now();
+        std::vector<std::future<void>> done;
+        done.push_back(s.submit(1, order.task("batch, none")));
+        done.push_back(s.submit(1, now + hours(3), order.task("batch, 3h")));
+        done.push_back(s.submit(1, now + hours(2), order.task("batch, 2h")));
+        done.push_back(s.submit(0, order.task("urgent, none")));
+        done.push_back(s.submit(0, now + hours(5), order.task("urgent, 5h")));
+        blocker.release();
+        for (auto& f : done) {
+            f.get();
+        }
+        std::vector<std::string> expected{"urgent, 5h", "urgent, none", "batch, 2h", "batch, 3h", "batch, none"};
+        assert(order.names == expected);
+        assert(s.stats(0).ran == 3 && s.stats(1).ran == 3 && s.stats(1).aged == 0);
+    }
+
+    // aging: a batch task that waited longer than maxWait gets one pick in agedEvery (here 2)
+    {
+        DeadlineScheduler s(2, 1, milliseconds(10), 2);
+        Blocker blocker(s);
+        RunOrder order;
+        std::vector<std::future<void>> done;
+        done.push_back(s.submit(1, order.task("batch")));
+        for (int i = 1; i <= 4; ++i) {
+            done.push_back(s.submit(0, order.task("urgent " + std::to_string(i))));
+        }
+        std::this_thread::sleep_for(milliseconds(30));
+        blocker.release();
+        for (auto& f : done) {
+            f.get();
+        }
+        std::vector<std::string> expected{"urgent 1", "batch", "urgent 2", "urgent 3", "urgent 4"};
+        assert(order.names == expected);
+        assert(s.stats(1).aged == 1 && s.stats(1).ran == 1 && s.stats(0).aged == 0);
+    }
+
+    // a deadline that passes in the queue: dropped, the future gets DeadlineExpired; one already passed at
+    // submit: rejected, DeadlineExpired thrown by submit
+    {
+        DeadlineScheduler s(1, 1);
+        Blocker blocker(s);
+        bool ran = false;
+        auto late = s.submit(0, Clock::now() + milliseconds(10), [&ran] { ran = true; });
+        auto onTime = s.submit(0, Clock::now() + hours(1), [] { return 7; });
+        std::this_thread::sleep_for(milliseconds(30));
+        blocker.release();
+        assert(onTime.get() == 7);
+        bool expired = false;
+        try {
+            late.get();
+        } catch (const DeadlineExpired&) {
+            expired = true;
+        }
+        assert(expired && !ran);
+
+        bool rejected = false;
+        try {
+            s.submit(0, Clock::now() - milliseconds(1), [] {});
+        } catch (const DeadlineExpired&) {
+            rejected = true;
+        }
+        assert(rejected);
+        DeadlineScheduler::ClassStats stats = s.stats(0);
+        assert(stats.dropped == 1 && stats.rejected == 1 && stats.ran == 2 && s.queued() == 0);
+    }
+}
+
+template <typename Fn>
+bool throwsFutureError(Fn fn, std::future_errc code) {
+    try {
+        fn();
+    } catch (const std::future_error& e) {
+        return e.code() == std::make_error_code(code);
+    }
+    return false;
+}
+
+void testUniqueFunction() {
+    using Fn = UniqueFunction<int(), 48>;
+    // inline up to the buffer size, on the heap above it
+    Fn small([] { return 1; });
+    int big[32] = {};
+    big[31] = 2;
+    Fn large([big] { return big[31]; });
+    assert(small.isInline() && !large.isInline());
+    assert(small() == 1 && large() == 2);
+
+    // moving keeps the storage kind; the moved-from function is empty and throws bad_function_call
+    Fn moved(std::move(large));
+    assert(!large && moved && !moved.isInline() && moved() == 2);
+    bool thrown = false;
+    try {
+        large();
+    } catch (const std::bad_function_call&) {
+        thrown = true;
+    }
+    assert(thrown);
+    thrown = false;
+    try {
+        Fn()();
+    } catch (const std::bad_function_call&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // move assignment over a live target destroys the old callable, inline or on the heap
+    auto token = std::make_shared<int>(0);
+    Fn holder([token] { return 3; });
+    Fn heapHolder([token, big] { return big[0]; });
+    assert(token.use_count() == 3);
+    holder = std::move(small);
+    heapHolder = std::move(moved);
+    assert(token.use_count() == 1);
+    assert(holder.isInline() && holder() == 1 && !small);
+    assert(!heapHolder.isInline() && heapHolder() == 2 && !moved);
+}
+
+void testPooledPromise() {
+    SharedStatePool<int> pool(4);
+
+    // a promise dropped without a value breaks it
+    PooledFuture<int> f;
+    {
+        PooledPromise<int> p(pool);
+        f = p.get_future();
+    }
+    assert(throwsFutureError([&] { f.get(); }, std::future_errc::broken_promise));
+    assert(!f.valid());
+
+    PooledPromise<int> p(pool);
+    PooledFuture<int> g = p.get_future();
+    assert(throwsFutureError([&] { p.get_future(); }, std::future_errc::future_already_retrieved));
+    p.set_value(5);
+    assert(throwsFutureError([&] { p.set_value(6); }, std::future_errc::promise_already_satisfied));
+    assert(g.isReady() && g.get() == 5);
+
+    // an exception through PooledFuture<void>, set on another thread
+    SharedStatePool<void> voidPool(1);
+    PooledPromise<void> done(voidPool);
+    PooledFuture<void> doneFuture = done.get_future();
+    std::thread([q = std::move(done)]() mutable {
+        q.set_exception(std::make_exception_ptr(std::runtime_error("boom")));
+    }).join();
+    bool thrown = false;
+    try {
+        doneFuture.get();
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // a submission of 0x22 (UniqueFunction holding a PooledPromise) reuses the pool's states: after warm-up,
+    // no allocation at all
+    using Task = UniqueFunction<void(), 48>;
+    auto submit = [&pool](int k) {
+        PooledPromise<int> promise(pool);
+        PooledFuture<int> future = promise.get_future();
+        Task t([k, promise = std::move(promise)]() mutable { promise.set_value(k * 2); });
+        assert(t.isInline());
+        t();
+        return future.get();
+    };
+    submit(0);
+    long before = allocations.load();
+    long sum = 0;
+    for (int k = 0; k < 1000; ++k) {
+        sum += submit(k);
+    }
+    assert(allocations.load() == before);
+    assert(sum == 999 * 1000 && pool.capacity() == 4);
+}
+
+BigUint randomBigUint(std::mt19937& rng, size_t limbs) {
+    bignum::Limbs v(limbs);
+    for (auto& limb : v) {
+        limb = static_cast<uint32_t>(rng());
+    }
+    v.back() |= 1u << 31; // exactly `limbs` limbs
+    return BigUint(std::move(v));
+}
+
+// Karatsuba against schoolbook on balanced operands (the combineKaratsuba split, at and above the threshold,
+// odd sizes) and unbalanced ones (one operand at most half the other: the sliced branch), then n! three ways
+void testBigUint() {
+    std::mt19937 rng(42);
+    const size_t t = bignum::karatsubaThreshold;
+    const std::pair<size_t, size_t> sizes[] = {{t, t},         {t + 1, t},       {2 * t + 1, 2 * t - 3},
+                                               {301, 257},     {1000, 999},      {3 * t, t},
+                                               {2 * t, t},     {1000, 120},      {777, 41}};
+    for (auto [na, nb] : sizes) {
+        BigUint a = randomBigUint(rng, na), b = randomBigUint(rng, nb);
+        BigUint school = a.multiply(b, MulAlgorithm::schoolbook);
+        assert(a.multiply(b, MulAlgorithm::karatsuba) == school);
+        assert(b.multiply(a, MulAlgorithm::karatsuba) == school);
+    }
+
+    assert(bigFactorial(0).toString() == "1");
+    assert(bigFactorial(13).toString() == "6227020800"); // where the int factorial overflows
+    assert(bigFactorial(30).toString() == "265252859812191058636308480000000");
+    assert(bigFactorial(30, MulAlgorithm::schoolbook) == bigFactorial(30));
+
+    // 5 workers: 20 leaves, then levels of 10 and 5 products; then fewer pairs than workers: a balanced pair is
+    // split into its three Karatsuba halves (combineKaratsuba) while the last fifth is carried up, and at the
+    // top that fifth is under half the size of the rest: an unbalanced pair, one job
+    ThreadPool pool(5);
+    for (uint32_t n : {1000u, 2500u, 6000u}) {
+        BigUint kara = bigFactorial(n);
+        assert(kara == bigFactorial(n, MulAlgorithm::schoolbook));
+        assert(parallelFactorial(n, pool) == kara);
+    }
+    ThreadPool single(1);
+    assert(parallelFactorial(3000, single) == bigFactorial(3000));
+}
+
+int main() {
+    testLogFile();
+    testThreadRAII();
+    testLazy();
+    testTimerWheelDelay();
+    testDeadlineScheduler();
+    testUniqueFunction();
+    testPooledPromise();
+    testBigUint();
+    std::cout << "test_concurrency: all tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,180 @@
+#ifndef THREAD_GROUP_HPP
+#define THREAD_GROUP_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include <pthread.h>
+#include <sched.h>
+
+// ThreadGroup: the ThreadRAII of 0x04-thread.cpp for a set of workers, built on std::jthread.
+// * cooperative cancellation: every worker gets a std::stop_token; requestStop() asks all of them to finish,
+//   and a worker blocked in condition_variable_any::wait(lock, token, pred) wakes up right away;
+// * bounded shutdown: joinFor()/joinUntil() wait at most until a deadline and report whether every worker
+//   finished, instead of a join() that can block forever on a worker that ignores the token;
+// * placement: a worker can be pinned to a set of CPUs (its cache stays warm, its memory stays local)
+//   and named (the name shows up in top -H, gdb and perf).
+// The destructor, like std::jthread's, requests stop and joins.
+// A ThreadGroup can not be copied or moved: stopping a group is an explicit call with a deadline, not a side
+// effect of an assignment (ThreadRAII's move assignment joins the old thread, for as long as it takes).
+// spawn() and the join functions are meant to be called by one controlling thread.
+
+struct ThreadOptions {
+    std::string name;      // up to 15 characters are kept (a Linux limit)
+    std::vector<int> cpus; // empty: may run on any CPU
+};
+
+// CPUs this process is allowed to run on
+inline std::vector<int> allowedCpus() {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    std::vector<int> cpus;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int c = 0; c < CPU_SETSIZE; ++c) {
+            if (CPU_ISSET(c, &set)) {
+                cpus.push_back(c);
+            }
+        }
+    }
+    return cpus;
+}
+
+// pins the calling thread to `cpus`; throws std::system_error (e.g. EINVAL for a CPU that is not online)
+inline void pinCurrentThread(const std::vector<int>& cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : cpus) {
+        if (c < 0 || c >= CPU_SETSIZE) {
+            throw std::system_error(EINVAL, std::generic_category(), "pinCurrentThread: cpu " + std::to_string(c));
+        }
+        CPU_SET(c, &set);
+    }
+    int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (err != 0) {
+        throw std::system_error(err, std::generic_category(), "pthread_setaffinity_np");
+    }
+}
+
+inline void nameCurrentThread(const std::string& name) {
+    pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+}
+
+class ThreadGroup {
+private:
+    std::vector<std::jthread> workers_;
+    std::mutex mtx_;
+    std::condition_variable finishedCv_;
+    size_t finished_ = 0; // workers whose function has returned
+
+    void markFinished() {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            ++finished_;
+        }
+        finishedCv_.notify_all();
+    }
+
+public:
+    ThreadGroup() = default;
+    ~ThreadGroup() {
+        requestStop();
+        for (auto& w : workers_) {
+            if (w.joinable()) {
+                w.join(); // here, not in ~jthread: the workers still use mtx_, which is destroyed first
+            }
+        }
+    }
+
+    ThreadGroup(const ThreadGroup&) = delete;
+    ThreadGroup& operator=(const ThreadGroup&) = delete;
+
+    // Starts `fn(std::stop_token)` on a new thread, pinned and named as in `options`.
+    // Returns once the thread is placed; a placement error is thrown here (and the thread does not run fn).
+    template <typename Fn>
+    void spawn(ThreadOptions options, Fn fn) {
+        std::promise<void> placed;
+        std::future<void> placedResult = placed.get_future();
+        std::jthread t([this, options = std::move(options), fn = std::move(fn), placed = std::move(placed)](
+                           std::stop_token token) mutable {
+            try {
+                if (!options.cpus.empty()) {
+                    pinCurrentThread(options.cpus);
+                }
+                if (!options.name.empty()) {
+                    nameCurrentThread(options.name);
+                }
+                placed.set_value();
+            } catch (...) {
+                placed.set_exception(std::current_exception());
+                return;
+            }
+            try {
+                fn(token);
+            } catch (...) {
+                markFinished();
+                throw; // like std::thread: an exception escaping a worker terminates the program
+            }
+            markFinished();
+        });
+        placedResult.get(); // rethrows a placement error; `t` is joined when it goes out of scope
+        workers_.push_back(std::move(t));
+    }
+
+    // one worker per CPU in `cpus`, pinned to it and named "<prefix>-<cpu>"; fn(token, index)
+    template <typename Fn>
+    void spawnPinned(const std::vector<int>& cpus, const std::string& prefix, Fn fn) {
+        for (size_t i = 0; i < cpus.size(); ++i) {
+            spawn({prefix + "-" + std::to_string(cpus[i]), {cpus[i]}},
+                  [fn, i](std::stop_token token) mutable { fn(token, i); });
+        }
+    }
+
+    void requestStop() {
+        for (auto& w : workers_) {
+            w.request_stop();
+        }
+    }
+
+    // Requests stop and waits until `deadline` for the workers to finish. Returns true if all of them did (and
+    // they are joined), false if some are still running: they stay in the group and can be waited for again.
+    template <typename Clock, typename Duration>
+    bool joinUntil(std::chrono::time_point<Clock, Duration> deadline) {
+        requestStop();
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            if (!finishedCv_.wait_until(lock, deadline, [this] { return finished_ == workers_.size(); })) {
+                return false;
+            }
+        }
+        for (auto& w : workers_) {
+            w.join(); // their functions have returned: this only waits for the threads to exit
+        }
+        workers_.clear();
+        std::lock_guard<std::mutex> lock(mtx_);
+        finished_ = 0;
+        return true;
+    }
+
+    template <typename Rep, typename Period>
+    bool joinFor(std::chrono::duration<Rep, Period> timeout) {
+        return joinUntil(std::chrono::steady_clock::now() + timeout);
+    }
+
+    size_t size() const { return workers_.size(); }
+
+    size_t running() {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return workers_.size() - finished_;
+    }
+};
+
+#endif // THREAD_GROUP_HPP
@@ -0,0 +1,158 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Task: a move-only `void()` callable.
+// std::function requires a copyable callable, so it can not hold a lambda that captures a std::promise
+// or a std::packaged_task (both are move-only, see 0x18-packaged_task.cpp).
+class Task {
+private:
+    struct Base {
+        virtual ~Base() = default;
+        virtual void call() = 0;
+    };
+    template <typename Fn>
+    struct Impl : Base {
+        Fn fn;
+        explicit Impl(Fn f) : fn(std::move(f)) {}
+        void call() override { fn(); }
+    };
+    std::unique_ptr<Base> impl_;
+
+public:
+    Task() = default;
+    template <typename Fn, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Fn>, Task>>>
+    Task(Fn&& fn) : impl_(std::make_unique<Impl<std::decay_t<Fn>>>(std::forward<Fn>(fn))) {}
+
+    Task(Task&&) noexcept = default;
+    Task& operator=(Task&&) noexcept = default;
+
+    void operator()() { impl_->call(); }
+    explicit operator bool() const noexcept { return impl_ != nullptr; }
+};
+
+// An executor is anything with `post(Task)`: it runs the task at some point, on some thread.
+template <typename E>
+concept Executor = requires(E& e, Task t) { e.post(std::move(t)); };
+
+// runs the task right away, on the calling thread
+class InlineExecutor {
+public:
+    void post(Task t) { t(); }
+};
+
+// ThreadPool: a fixed number of worker threads sharing one task queue (the worker_thread loop of
+// 0x18/0x19 as a class). The destructor runs the tasks that are still queued, then joins the workers.
+// With `maxQueued > 0` the queue is bounded: post() waits while it is full, so a fast producer is slowed
+// down instead of piling up tasks (and memory).
+class ThreadPool {
+private:
+    std::vector<std::thread> workers_;
+    std::deque<Task> tasks_;
+    const size_t maxQueued_; // 0: unbounded
+    size_t idle_ = 0;        // workers waiting for a task
+    size_t waitingPosters_ = 0;
+    mutable std::mutex mtx_;
+    std::condition_variable cv_;
+    std::condition_variable notFull_;
+    bool stopping_ = false;
+
+    void workerLoop() {
+        while (true) {
+            Task task;
+            {
+                std::unique_lock<std::mutex> lock(mtx_);
+                if (!stopping_ && tasks_.empty()) {
+                    ++idle_;
+                    cv_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+                    --idle_;
+                }
+                if (tasks_.empty()) {
+                    return; // stopping and nothing left to do
+                }
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+                if (waitingPosters_ > 0) {
+                    notFull_.notify_one();
+                }
+            }
+            task();
+        }
+    }
+
+    // mtx_ must be held (and is released)
+    void pushLocked(std::unique_lock<std::mutex>& lock, Task& t) {
+        tasks_.push_back(std::move(t));
+        bool wake = idle_ > 0;
+        lock.unlock();
+        if (wake) {
+            cv_.notify_one();
+        }
+    }
+
+public:
+    explicit ThreadPool(size_t threads = std::thread::hardware_concurrency(), size_t maxQueued = 0)
+        : maxQueued_(maxQueued) {
+        if (threads == 0) {
+            threads = 1;
+        }
+        workers_.reserve(threads);
+        for (size_t i = 0; i < threads; ++i) {
+            workers_.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        notFull_.notify_all();
+        for (auto& w : workers_) {
+            w.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // waits while a bounded queue is full
+    void post(Task t) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        if (maxQueued_ > 0 && tasks_.size() >= maxQueued_) {
+            ++waitingPosters_;
+            notFull_.wait(lock, [this] { return stopping_ || tasks_.size() < maxQueued_; });
+            --waitingPosters_;
+        }
+        pushLocked(lock, t);
+    }
+
+    // queues `t` only if a worker is idle and will pick it up right away; otherwise returns false
+    // and leaves `t` with the caller
+    bool tryPostToIdle(Task& t) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        if (idle_ <= tasks_.size()) {
+            return false;
+        }
+        pushLocked(lock, t);
+        return true;
+    }
+
+    size_t size() const { return workers_.size(); }
+    size_t queued() const {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return tasks_.size();
+    }
+};
+
+#endif // THREAD_POOL_HPP
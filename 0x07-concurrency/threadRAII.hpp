@@ -0,0 +1,58 @@
+#ifndef THREAD_RAII_HPP
+#define THREAD_RAII_HPP
+
+#include <stdexcept>
+#include <thread>
+
+class ThreadRAII {
+public:
+    // DtorAction: Destructor Action
+    enum class DtorAction { join, detach }; // Choose action in destructor
+
+    ThreadRAII(std::thread t, DtorAction action)
+        : t_(std::move(t)), action_(action) {
+        if (!t_.joinable()) {
+            throw std::logic_error("No thread to manage");
+        }
+    }
+
+    // Destructor to join or detach the thread based on `DtorAction`
+    ~ThreadRAII() {
+        if (t_.joinable()) {
+            if (action_ == DtorAction::join) {
+                t_.join();
+            } else {
+                t_.detach();
+            }
+        }
+    }
+
+    // Delete copy operations to avoid unintended behavior
+    ThreadRAII(const ThreadRAII&) = delete;
+    ThreadRAII& operator=(const ThreadRAII&) = delete;
+
+    // Move constructor and assignment to allow transfer of ownership
+    ThreadRAII(ThreadRAII&& other) noexcept
+        : t_(std::move(other.t_)), action_(other.action_) {}
+
+    ThreadRAII& operator=(ThreadRAII&& other) noexcept {
+        if (this != &other) {
+            if (t_.joinable()) {
+                if (action_ == DtorAction::join) {
+                    t_.join();
+                } else {
+                    t_.detach();
+                }
+            }
+            t_ = std::move(other.t_);
+            action_ = other.action_;
+        }
+        return *this;
+    }
+
+private:
+    std::thread t_; // Wrapped thread
+    DtorAction action_; // Action to perform on destruction
+};
+
+#endif // THREAD_RAII_HPP
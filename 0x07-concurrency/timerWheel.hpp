@@ -0,0 +1,332 @@
+#ifndef TIMER_WHEEL_HPP
+#define TIMER_WHEEL_HPP
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "threadPool.hpp"
+
+// TimerWheel: delayed and periodic callbacks without a sleeping thread per timer.
+// Time is counted in ticks (1ms by default). The wheel has 4 levels of 256 slots:
+// level 0 holds the timers due in the next 256 ticks (one slot per tick), level 1 the ones due in the next
+// 256*256 ticks (one slot per 256 ticks), and so on up to 2^32 ticks (49 days at 1ms).
+// Every 256 ticks the next slot of level 1 is "cascaded": its timers move down to level 0, now that their exact
+// tick fits there (and the same between the higher levels, like the hierarchical wheel of the Linux kernel).
+// * schedule() and cancel() are O(1): a slot is a vector of node indices, every node knows its position in it,
+//   and cancel() moves the last entry of the slot into the hole. (A doubly linked list per slot is O(1) too,
+//   but firing a slot then chases one pointer per timer, one cache miss after the other; with an index
+//   vector the CPU loads many nodes at the same time.)
+// * a tick costs O(1) plus the timers that fire (or cascade) in it, and while level 0 is empty the wheel jumps
+//   straight to the next cascade instead of walking the empty ticks;
+// * due callbacks are posted to the executor, outside the wheel's lock, so a callback can schedule or cancel.
+//
+// Drive it with start() (a thread wakes up every tick while there are timers), or by hand with advance().
+template <Executor E>
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+    using TimerId = uint64_t; // slot index in the low 32 bits, generation in the high 32 bits
+
+private:
+    static constexpr int levelBits = 8;
+    static constexpr int levels = 4;
+    static constexpr uint32_t slots = 1u << levelBits;
+    static constexpr uint32_t slotMask = slots - 1;
+
+    struct Node {
+        uint64_t expiry = 0;          // absolute tick
+        uint64_t period = 0;          // ticks, 0: one-shot
+        uint32_t pos = 0;             // index in its slot
+        uint32_t generation = 0;      // bumped when the node is freed, so an old TimerId can not cancel its reuse
+        uint16_t level = 0, slot = 0;
+        bool active = false;
+        Task fn;                       // one-shot callback
+        std::shared_ptr<Task> repeat;  // periodic callback (posted once per period)
+    };
+
+    E& ex_;
+    const Clock::duration tick_;
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> freeNodes_;
+    std::vector<uint32_t> firing_; // the slot being fired (kept to reuse its capacity)
+    std::array<std::array<std::vector<uint32_t>, slots>, levels> slots_;
+    uint64_t current_ = 0;    // the last tick processed
+    size_t count_ = 0;        // active timers
+    size_t level0Count_ = 0;  // timers in level 0
+
+    mutable std::mutex mtx_;
+    std::condition_variable cv_;
+    Clock::time_point start_;
+    std::thread driver_;
+    bool stopping_ = false;
+
+    uint64_t ticksFor(Clock::duration d) const {
+        if (d <= Clock::duration::zero()) {
+            return 1;
+        }
+        uint64_t t = (d + tick_ - Clock::duration(1)) / tick_; // round up: never fire early
+        return t > 0 ? t : 1;
+    }
+
+    void link(uint32_t i) {
+        Node& n = nodes_[i];
+        if (n.expiry < current_) {
+            n.expiry = current_; // can not happen, but a late timer must still land in a slot that gets fired
+        }
+        uint64_t delta = n.expiry - current_;
+        int level = 0;
+        while (level < levels - 1 && delta >= (uint64_t(1) << (levelBits * (level + 1)))) {
+            ++level;
+        }
+        uint64_t at = n.expiry;
+        if (level == levels - 1 && delta >= (uint64_t(1) << (levelBits * levels))) {
+            at = current_ + (uint64_t(1) << (levelBits * levels)) - 1; // too far: park it in the last slot,
+        }                                                              // it is relinked when cascaded
+        n.level = static_cast<uint16_t>(level);
+        n.slot = static_cast<uint16_t>((at >> (levelBits * level)) & slotMask);
+        std::vector<uint32_t>& slot = slots_[level][n.slot];
+        n.pos = static_cast<uint32_t>(slot.size());
+        slot.push_back(i);
+        if (level == 0) {
+            ++level0Count_;
+        }
+    }
+
+    void unlink(uint32_t i) {
+        Node& n = nodes_[i];
+        std::vector<uint32_t>& slot = slots_[n.level][n.slot];
+        uint32_t last = slot.back();
+        slot[n.pos] = last;
+        nodes_[last].pos = n.pos;
+        slot.pop_back();
+        if (n.level == 0) {
+            --level0Count_;
+        }
+    }
+
+    uint32_t allocNode() {
+        if (!freeNodes_.empty()) {
+            uint32_t i = freeNodes_.back();
+            freeNodes_.pop_back();
+            return i;
+        }
+        nodes_.emplace_back();
+        return static_cast<uint32_t>(nodes_.size() - 1);
+    }
+
+    void freeNode(uint32_t i) {
+        Node& n = nodes_[i];
+        n.active = false;
+        n.fn = Task();
+        n.repeat.reset();
+        ++n.generation;
+        freeNodes_.push_back(i);
+        --count_;
+    }
+
+    // moves the timers of one slot to lower levels; returns the slot index
+    uint32_t cascade(int level) {
+        uint32_t slot = (current_ >> (levelBits * level)) & slotMask;
+        std::vector<uint32_t> moving;
+        moving.swap(slots_[level][slot]);
+        for (uint32_t i : moving) {
+            link(i);
+        }
+        return slot;
+    }
+
+    // mtx_ must be held; the callbacks due at the new tick are appended to `due`
+    void advanceOne(std::vector<Task>& due) {
+        ++current_;
+        if ((current_ & slotMask) == 0) {
+            for (int level = 1; level < levels && cascade(level) == 0; ++level) {
+            }
+        }
+        std::vector<uint32_t>& slot = slots_[0][current_ & slotMask];
+        firing_.swap(slot); // periodic timers can be relinked into this same slot
+        level0Count_ -= firing_.size();
+        for (uint32_t i : firing_) {
+            Node& n = nodes_[i];
+            if (n.repeat) {
+                due.push_back([cb = n.repeat] { (*cb)(); });
+                n.expiry = current_ + n.period;
+                link(i);
+            } else {
+                due.push_back(std::move(n.fn));
+                freeNode(i);
+            }
+        }
+        firing_.clear();
+    }
+
+    // mtx_ must be held; processes `ticks` ticks
+    void advanceLocked(uint64_t ticks, std::vector<Task>& due) {
+        while (ticks > 0) {
+            if (level0Count_ == 0) {
+                // nothing can fire before the next cascade (when current_ reaches a multiple of 256)
+                uint64_t skip = std::min<uint64_t>(ticks, slotMask - (current_ & slotMask));
+                current_ += skip;
+                ticks -= skip;
+                if (ticks == 0) {
+                    break;
+                }
+            }
+            advanceOne(due);
+            --ticks;
+        }
+    }
+
+    void post(std::vector<Task>& due) {
+        for (auto& t : due) {
+            ex_.post(std::move(t));
+        }
+        due.clear();
+    }
+
+    uint64_t elapsedTicks(Clock::time_point now) const {
+        return static_cast<uint64_t>((now - start_) / tick_);
+    }
+
+    void driverLoop() {
+        std::vector<Task> due;
+        std::unique_lock<std::mutex> lock(mtx_);
+        while (!stopping_) {
+            if (count_ == 0) {
+                cv_.wait(lock, [this] { return stopping_ || count_ > 0; });
+                continue;
+            }
+            uint64_t target = elapsedTicks(Clock::now());
+            if (target > current_) {
+                advanceLocked(target - current_, due);
+            }
+            if (count_ == 0) {
+                current_ = target; // nothing left: jump ahead instead of walking empty ticks
+            }
+            if (!due.empty()) {
+                lock.unlock();
+                post(due);
+                lock.lock();
+                continue;
+            }
+            uint64_t next = level0Count_ > 0 ? current_ + 1 : (current_ | slotMask) + 1; // the next cascade
+            cv_.wait_until(lock, start_ + next * tick_);
+        }
+    }
+
+    TimerId add(Clock::duration delay, uint64_t period, Task fn, std::shared_ptr<Task> repeat) {
+        std::vector<Task> due;
+        TimerId id;
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            if (driver_.joinable()) {
+                // the driver does not keep current_ up to date: idle, or sleeping until the next cascade while
+                // level 0 is empty, it can trail the clock by up to 255 ticks. The delay counts from now.
+                uint64_t now = elapsedTicks(Clock::now());
+                if (count_ == 0) {
+                    current_ = std::max(current_, now);
+                } else if (now > current_) {
+                    advanceLocked(now - current_, due);
+                }
+            }
+            uint32_t i = allocNode();
+            Node& n = nodes_[i];
+            // with the driver, part of the current tick has already passed: count the delay from the next one
+            n.expiry = current_ + ticksFor(delay) + (driver_.joinable() ? 1 : 0);
+            n.period = period;
+            n.fn = std::move(fn);
+            n.repeat = std::move(repeat);
+            n.active = true;
+            link(i);
+            if (++count_ == 1 || n.level == 0) {
+                cv_.notify_one(); // the driver may be sleeping until later than this timer
+            }
+            id = (uint64_t(n.generation) << 32) | i;
+        }
+        post(due); // nothing can be due when current_ was up to date, but catching up may have fired timers
+        return id;
+    }
+
+public:
+    explicit TimerWheel(E& ex, Clock::duration tick = std::chrono::milliseconds(1))
+        : ex_(ex), tick_(tick > Clock::duration::zero() ? tick : Clock::duration(1)), start_(Clock::now()) {
+    }
+
+    ~TimerWheel() { stop(); }
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // runs `fn` on the executor once, `delay` from now (rounded up to whole ticks)
+    TimerId schedule(Clock::duration delay, Task fn) {
+        return add(delay, 0, std::move(fn), nullptr);
+    }
+
+    // runs `fn` every `period`, the first time `period` from now. If the executor is slower than the period,
+    // two runs of fn can overlap.
+    TimerId schedulePeriodic(Clock::duration period, Task fn) {
+        return add(period, ticksFor(period), Task(), std::make_shared<Task>(std::move(fn)));
+    }
+
+    // false if the timer already fired (one-shot) or was cancelled
+    bool cancel(TimerId id) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        uint32_t i = static_cast<uint32_t>(id);
+        if (i >= nodes_.size() || nodes_[i].generation != static_cast<uint32_t>(id >> 32) || !nodes_[i].active) {
+            return false;
+        }
+        unlink(i);
+        freeNode(i);
+        return true;
+    }
+
+    // manual driving: processes `ticks` ticks, returns the number of callbacks posted
+    size_t advance(uint64_t ticks) {
+        std::vector<Task> due;
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            advanceLocked(ticks, due);
+        }
+        size_t n = due.size();
+        post(due);
+        return n;
+    }
+
+    // starts a thread that advances the wheel with the clock
+    void start() {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (!driver_.joinable()) {
+            start_ = Clock::now() - current_ * tick_;
+            stopping_ = false;
+            driver_ = std::thread([this] { driverLoop(); });
+        }
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        if (driver_.joinable()) {
+            driver_.join();
+        }
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return count_;
+    }
+    uint64_t currentTick() const {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return current_;
+    }
+};
+
+#endif // TIMER_WHEEL_HPP
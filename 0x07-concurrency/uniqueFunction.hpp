@@ -0,0 +1,127 @@
+#ifndef UNIQUE_FUNCTION_HPP
+#define UNIQUE_FUNCTION_HPP
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// UniqueFunction<R(Args...), InlineSize>: a move-only std::function with small-object storage.
+// * move-only, like Task in threadPool.hpp, so it can hold a lambda that captures a promise or a packaged_task;
+// * a callable of up to `InlineSize` bytes (and no stricter alignment than max_align_t, and a noexcept move) is
+//   stored inside the object itself: constructing, moving and destroying it never allocates. A bigger one goes
+//   to the heap, like in std::function.
+// The type is erased with a table of three function pointers per callable type (call, move, destroy) instead of
+// a virtual base class, so the inline buffer holds the callable itself and nothing else.
+template <typename Sig, size_t InlineSize = 3 * sizeof(void*)>
+class UniqueFunction;
+
+template <typename R, typename... Args, size_t InlineSize>
+class UniqueFunction<R(Args...), InlineSize> {
+    static_assert(InlineSize >= sizeof(void*), "the inline buffer must at least hold a pointer");
+
+private:
+    struct VTable {
+        R (*call)(void* storage, Args&&... args);
+        void (*move)(void* dst, void* src) noexcept; // move-constructs into dst and destroys src
+        void (*destroy)(void* storage) noexcept;
+    };
+
+    template <typename Fn>
+    static constexpr bool fitsInline = sizeof(Fn) <= InlineSize && alignof(Fn) <= alignof(std::max_align_t) &&
+                                       std::is_nothrow_move_constructible_v<Fn>;
+
+    template <typename Fn>
+    static constexpr VTable inlineTable = {
+        [](void* s, Args&&... args) -> R { return std::invoke(*static_cast<Fn*>(s), std::forward<Args>(args)...); },
+        [](void* dst, void* src) noexcept {
+            ::new (dst) Fn(std::move(*static_cast<Fn*>(src)));
+            static_cast<Fn*>(src)->~Fn();
+        },
+        [](void* s) noexcept { static_cast<Fn*>(s)->~Fn(); },
+    };
+
+    // the buffer holds a Fn*
+    template <typename Fn>
+    static constexpr VTable heapTable = {
+        [](void* s, Args&&... args) -> R { return std::invoke(**static_cast<Fn**>(s), std::forward<Args>(args)...); },
+        [](void* dst, void* src) noexcept { *static_cast<Fn**>(dst) = *static_cast<Fn**>(src); },
+        [](void* s) noexcept { delete *static_cast<Fn**>(s); },
+    };
+
+    alignas(std::max_align_t) unsigned char storage_[InlineSize];
+    const VTable* vtable_ = nullptr;
+    // vtable_->call, copied here: a call loads one pointer instead of two dependent ones
+    R (*call_)(void* storage, Args&&... args) = nullptr;
+    bool inline_ = false;
+
+    void reset() noexcept {
+        if (vtable_) {
+            vtable_->destroy(storage_);
+            vtable_ = nullptr;
+            call_ = nullptr;
+        }
+    }
+
+public:
+    UniqueFunction() = default;
+
+    template <typename Fn, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Fn>, UniqueFunction> &&
+                                                       std::is_invocable_r_v<R, std::decay_t<Fn>&, Args...>>>
+    UniqueFunction(Fn&& fn) {
+        using F = std::decay_t<Fn>;
+        if constexpr (fitsInline<F>) {
+            ::new (static_cast<void*>(storage_)) F(std::forward<Fn>(fn));
+            vtable_ = &inlineTable<F>;
+            inline_ = true;
+        } else {
+            *reinterpret_cast<F**>(storage_) = new F(std::forward<Fn>(fn));
+            vtable_ = &heapTable<F>;
+        }
+        call_ = vtable_->call;
+    }
+
+    UniqueFunction(UniqueFunction&& other) noexcept
+        : vtable_(other.vtable_), call_(other.call_), inline_(other.inline_) {
+        if (vtable_) {
+            vtable_->move(storage_, other.storage_);
+            other.vtable_ = nullptr;
+            other.call_ = nullptr;
+        }
+    }
+
+    UniqueFunction& operator=(UniqueFunction&& other) noexcept {
+        if (this != &other) {
+            reset();
+            if (other.vtable_) {
+                other.vtable_->move(storage_, other.storage_);
+                vtable_ = other.vtable_;
+                call_ = other.call_;
+                inline_ = other.inline_;
+                other.vtable_ = nullptr;
+                other.call_ = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    UniqueFunction(const UniqueFunction&) = delete;
+    UniqueFunction& operator=(const UniqueFunction&) = delete;
+
+    ~UniqueFunction() { reset(); }
+
+    R operator()(Args... args) {
+        if (!call_) {
+            throw std::bad_function_call();
+        }
+        return call_(storage_, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const noexcept { return vtable_ != nullptr; }
+
+    // true if the callable is stored in the object (no heap allocation)
+    bool isInline() const noexcept { return vtable_ && inline_; }
+};
+
+#endif // UNIQUE_FUNCTION_HPP
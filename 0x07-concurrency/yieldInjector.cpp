@@ -0,0 +1,94 @@
+// yieldInjector.cpp: a preload library that shakes up the thread schedule, for race_check.sh stress mode.
+// A race that needs an unlucky interleaving rarely shows up when a program runs alone on an idle machine: the
+// threads run in the same order every time. Loaded with LD_PRELOAD, this library wraps the pthread calls under
+// std::mutex and std::condition_variable, and before (or after) each one randomly yields the CPU or sleeps a
+// few microseconds, so every run takes a different interleaving.
+// build: g++ -O2 -shared -fPIC yieldInjector.cpp -o libyieldinjector.so -ldl
+// run:   YIELD_SEED=7 YIELD_PERCENT=20 LD_PRELOAD=./libyieldinjector.so ./a.out
+#include <dlfcn.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+
+namespace {
+
+std::atomic<uint64_t> threadCounter{0};
+thread_local uint64_t rngState = 0;
+
+uint64_t envOr(const char* name, uint64_t fallback) {
+    const char* v = std::getenv(name);
+    return v ? std::strtoull(v, nullptr, 10) : fallback;
+}
+
+// xorshift64*, seeded per thread from YIELD_SEED and the thread's creation order
+uint64_t nextRandom() {
+    if (rngState == 0) {
+        rngState = (envOr("YIELD_SEED", 1) + 1) * 0x9E3779B97F4A7C15ull ^ (threadCounter.fetch_add(1) + 1) * 0xBF58476D1CE4E5B9ull;
+        if (rngState == 0) {
+            rngState = 1;
+        }
+    }
+    rngState ^= rngState >> 12;
+    rngState ^= rngState << 25;
+    rngState ^= rngState >> 27;
+    return rngState * 0x2545F4914F6CDD1Dull;
+}
+
+void perturb() {
+    static const uint64_t percent = envOr("YIELD_PERCENT", 20);
+    uint64_t r = nextRandom();
+    if (r % 100 >= percent) {
+        return;
+    }
+    if ((r >> 8) & 1) {
+        sched_yield();
+    } else {
+        timespec ts{0, static_cast<long>((r >> 16) % 50'000)}; // up to 50 us
+        nanosleep(&ts, nullptr);
+    }
+}
+
+template <typename Fn>
+Fn real(std::atomic<Fn>& slot, const char* name) {
+    Fn fn = slot.load(std::memory_order_acquire);
+    if (!fn) {
+        fn = reinterpret_cast<Fn>(dlsym(RTLD_NEXT, name));
+        slot.store(fn, std::memory_order_release);
+    }
+    return fn;
+}
+
+using MutexFn = int (*)(pthread_mutex_t*);
+using CondFn = int (*)(pthread_cond_t*);
+std::atomic<MutexFn> realLock{nullptr}, realUnlock{nullptr};
+std::atomic<CondFn> realSignal{nullptr}, realBroadcast{nullptr};
+
+} // namespace
+
+extern "C" {
+
+int pthread_mutex_lock(pthread_mutex_t* m) {
+    perturb();
+    return real(realLock, "pthread_mutex_lock")(m);
+}
+
+int pthread_mutex_unlock(pthread_mutex_t* m) {
+    int r = real(realUnlock, "pthread_mutex_unlock")(m);
+    perturb();
+    return r;
+}
+
+int pthread_cond_signal(pthread_cond_t* c) {
+    perturb();
+    return real(realSignal, "pthread_cond_signal")(c);
+}
+
+int pthread_cond_broadcast(pthread_cond_t* c) {
+    perturb();
+    return real(realBroadcast, "pthread_cond_broadcast")(c);
+}
+
+} // extern "C"
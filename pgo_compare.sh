@@ -0,0 +1,87 @@
+#!/usr/bin/env bash
+# pgo_compare.sh: builds the benchmarks three ways and compares their numbers:
+# * release:     -O3, the baseline;
+# * release-lto: the same with link-time optimization (ThinLTO with Clang, -flto=auto with GCC);
+# * pgo:         an instrumented build (preset pgo-instrument) runs the benchmarks themselves as training,
+#                then the preset pgo-use rebuilds in the same directory with the profiles and LTO.
+# The training runs are the benchmark binaries: GCC writes the profile of an object file only from the
+# programs linked with it, so running the examples would not train the code of bench_*. They train with other
+# payload sizes than the ones they are measured with, so the profile is not tuned to the exact inputs that
+# are timed.
+# Every build runs the same benchmarks with the same options; the results go to $OUT/<build>.<bench>.json
+# (one JSON document per benchmark binary, with the commit in the context) and the comparison table to
+# $OUT/summary.txt.
+# usage: ./pgo_compare.sh [benchmark_filter]
+#        MIN_TIME=0.2 REPETITIONS=5 BENCHES="bench_stl bench_oop" ./pgo_compare.sh push_back
+set -eu
+
+cd "$(dirname "$0")"
+FILTER=${1:-}
+MIN_TIME=${MIN_TIME:-0.2}
+REPETITIONS=${REPETITIONS:-5}
+BENCHES=${BENCHES:-bench_stl bench_oop bench_concurrency}
+JOBS=${JOBS:-$(nproc)}
+OUT=$(mkdir -p "${OUT:-_build/pgo-compare}" && cd "${OUT:-_build/pgo-compare}" && pwd)
+COMMIT=$(git rev-parse --short HEAD 2>/dev/null || echo unknown)
+
+configure_and_build() { # preset targets...
+    local preset=$1
+    shift
+    echo "== $preset"
+    cmake --preset "$preset" >"$OUT/$preset.configure.log"
+    cmake --build --preset "$preset" -j"$JOBS" --target "$@" >"$OUT/$preset.build.log" 2>&1 ||
+        { echo "build failed, see $OUT/$preset.build.log"; exit 1; }
+}
+
+measure() { # build_dir name
+    for b in $BENCHES; do
+        "$1/bin/$b" --filter="$FILTER" --min_time="$MIN_TIME" --repetitions="$REPETITIONS" \
+            --json="$OUT/$2.$b.json" --context=build="$2" --context=commit="$COMMIT" >"$OUT/$2.$b.log"
+    done
+}
+
+train() { # build_dir
+    for b in $BENCHES; do
+        "$1/bin/$b" --filter="$FILTER" --min_time=0.02 --repetitions=1 --payloads=64,4096 >/dev/null
+    done
+}
+
+configure_and_build release $BENCHES
+measure "$PWD/_build/release" release
+
+configure_and_build release-lto $BENCHES
+measure "$PWD/_build/release-lto" release-lto
+
+# old profiles would be merged into the new ones: start from nothing
+find _build/pgo -name '*.gcda' -delete 2>/dev/null || true
+rm -rf _build/pgo/pgo-profiles
+configure_and_build pgo-instrument $BENCHES
+echo "== training"
+train "$PWD/_build/pgo"
+if ls _build/pgo/pgo-profiles/*.profraw >/dev/null 2>&1; then # Clang: the raw profiles have to be merged
+    llvm-profdata merge -o _build/pgo/pgo-profiles/default.profdata _build/pgo/pgo-profiles/*.profraw
+fi
+configure_and_build pgo-use $BENCHES
+measure "$PWD/_build/pgo" pgo
+
+# the JSON files are written by benchSuite.hpp, one key per line: pair every "name" with its "real_time"
+json_files=""
+for build in release release-lto pgo; do
+    for b in $BENCHES; do
+        json_files="$json_files $OUT/$build.$b.json"
+    done
+done
+awk '
+    function saved(base, t) { return base > 0 ? 100 * (base - t) / base : 0 }
+    FNR == 1 { build = FILENAME; sub(/.*\//, "", build); sub(/\..*/, "", build) }
+    /"name":/ { name = $0; sub(/.*"name": "/, "", name); sub(/",$/, "", name); if (!(name in seen)) { seen[name] = 1; order[n++] = name } }
+    /"real_time":/ { t = $2; sub(/,$/, "", t); ns[build, name] = t }
+    END {
+        printf "%-56s %12s %12s %12s %9s %9s\n", "benchmark (ns/op)", "release", "release-lto", "pgo+lto", "lto", "pgo+lto"
+        for (i = 0; i < n; ++i) {
+            k = order[i]; base = ns["release", k]; lto = ns["release-lto", k]; pgo = ns["pgo", k]
+            printf "%-56s %12.2f %12.2f %12.2f %+8.1f%% %+8.1f%%\n", k, base, lto, pgo, saved(base, lto), saved(base, pgo)
+        }
+        print "(the last two columns: time saved relative to release, positive is faster)"
+    }
+' $json_files | tee "$OUT/summary.txt"